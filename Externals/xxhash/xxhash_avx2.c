@@ -0,0 +1,13 @@
+/*
+ * Dolphin: instantiates xxhash.h a second time with the AVX2 XXH3 kernels.
+ * This file is built with AVX2 code generation, and its functions carry an
+ * XXH_avx2_ prefix so they can be picked at runtime next to the baseline build.
+ */
+
+#define XXH_NAMESPACE XXH_avx2_
+#define XXH_VECTOR XXH_AVX2
+
+#define XXH_STATIC_LINKING_ONLY /* access advanced declarations */
+#define XXH_IMPLEMENTATION      /* access definitions */
+
+#include "xxhash.h"
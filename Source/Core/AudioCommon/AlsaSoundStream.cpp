@@ -2,17 +2,23 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <mutex>
 
 #include "AudioCommon/AlsaSoundStream.h"
 #include "Common/CommonTypes.h"
 #include "Common/Thread.h"
 #include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
 
 AlsaSound::AlsaSound()
 	: m_thread_status(ALSAThreadStatus::STOPPED)
 	, handle(nullptr)
 	, frames_to_deliver(FRAME_COUNT_MIN)
+	, m_low_latency(false)
+	, m_buffer_size(0)
+	, m_fill_target(0)
+	, m_periods_since_underrun(0)
 {
 }
 
@@ -52,17 +58,42 @@ void AlsaSound::SoundLoop()
 	{
 		while (m_thread_status.load() == ALSAThreadStatus::RUNNING)
 		{
+			// Only mix once the device wants more, so that the samples are as fresh as possible
+			// instead of sitting in the buffer behind a blocking write.
+			if (m_low_latency && snd_pcm_wait(handle, 100) == 0)
+				continue;
+
 			m_mixer->Mix(mix_buffer, frames_to_deliver);
 			int rc = snd_pcm_writei(handle, mix_buffer, frames_to_deliver);
 			if (rc == -EPIPE)
 			{
 				// Underrun
+				m_telemetry.OnUnderrun();
 				snd_pcm_prepare(handle);
+				if (m_low_latency)
+				{
+					m_periods_since_underrun = 0;
+					SetFillTarget(m_fill_target + frames_to_deliver);
+					WARN_LOG(AUDIO, "ALSA underrun, keeping %lu frames queued now", m_fill_target);
+				}
 			}
 			else if (rc < 0)
 			{
 				ERROR_LOG(AUDIO, "writei fail: %s", snd_strerror(rc));
 			}
+			else
+			{
+				snd_pcm_sframes_t delay;
+				if (snd_pcm_delay(handle, &delay) == 0 && delay >= 0)
+					m_telemetry.OnWrite((u32)delay);
+
+				if (m_low_latency && ++m_periods_since_underrun >= LOW_LATENCY_DECAY_PERIODS &&
+				    m_fill_target > LOW_LATENCY_MIN_PERIODS * frames_to_deliver)
+				{
+					m_periods_since_underrun = 0;
+					SetFillTarget(m_fill_target - frames_to_deliver);
+				}
+			}
 		}
 		if (m_thread_status.load() == ALSAThreadStatus::PAUSED)
 		{
@@ -97,7 +128,9 @@ bool AlsaSound::AlsaInit()
 	snd_pcm_uframes_t buffer_size,buffer_size_max;
 	unsigned int periods;
 
-	err = snd_pcm_open(&handle, "default", SND_PCM_STREAM_PLAYBACK, 0);
+	m_low_latency = SConfig::GetInstance().bLowLatencyAudio;
+
+	err = snd_pcm_open(&handle, SConfig::GetInstance().sAlsaDevice.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
 	if (err < 0)
 	{
 		ERROR_LOG(AUDIO, "Audio open error: %s\n", snd_strerror(err));
@@ -142,12 +175,27 @@ bool AlsaSound::AlsaInit()
 		return false;
 	}
 
-	periods = BUFFER_SIZE_MAX / FRAME_COUNT_MIN;
-	err = snd_pcm_hw_params_set_periods_max(handle, hwparams, &periods, &dir);
-	if (err < 0)
+	if (m_low_latency)
 	{
-		ERROR_LOG(AUDIO, "Cannot set maximum periods per buffer: %s\n", snd_strerror(err));
-		return false;
+		// Small periods so that the device wakes us up often, how much of the buffer is
+		// actually kept filled is decided by the fill target.
+		snd_pcm_uframes_t period_size = LOW_LATENCY_PERIOD_FRAMES;
+		err = snd_pcm_hw_params_set_period_size_near(handle, hwparams, &period_size, &dir);
+		if (err < 0)
+		{
+			ERROR_LOG(AUDIO, "Cannot set period size: %s\n", snd_strerror(err));
+			return false;
+		}
+	}
+	else
+	{
+		periods = BUFFER_SIZE_MAX / FRAME_COUNT_MIN;
+		err = snd_pcm_hw_params_set_periods_max(handle, hwparams, &periods, &dir);
+		if (err < 0)
+		{
+			ERROR_LOG(AUDIO, "Cannot set maximum periods per buffer: %s\n", snd_strerror(err));
+			return false;
+		}
 	}
 
 	buffer_size_max = BUFFER_SIZE_MAX;
@@ -179,12 +227,26 @@ bool AlsaSound::AlsaInit()
 		return false;
 	}
 
-	//periods is the number of fragments alsa can wait for during one
-	//buffer_size
-	frames_to_deliver = buffer_size / periods;
-	//limit the minimum size. pulseaudio advertises a minimum of 32 samples.
-	if (frames_to_deliver < FRAME_COUNT_MIN)
-		frames_to_deliver = FRAME_COUNT_MIN;
+	if (m_low_latency)
+	{
+		snd_pcm_uframes_t period_size;
+		err = snd_pcm_hw_params_get_period_size(hwparams, &period_size, &dir);
+		if (err < 0)
+		{
+			ERROR_LOG(AUDIO, "Cannot get period size: %s\n", snd_strerror(err));
+			return false;
+		}
+		frames_to_deliver = period_size;
+	}
+	else
+	{
+		//periods is the number of fragments alsa can wait for during one
+		//buffer_size
+		frames_to_deliver = buffer_size / periods;
+		//limit the minimum size. pulseaudio advertises a minimum of 32 samples.
+		if (frames_to_deliver < FRAME_COUNT_MIN)
+			frames_to_deliver = FRAME_COUNT_MIN;
+	}
 	//it is probably a bad idea to try to send more than one buffer of data
 	if ((unsigned int)frames_to_deliver > buffer_size)
 		frames_to_deliver = buffer_size;
@@ -213,6 +275,12 @@ bool AlsaSound::AlsaInit()
 		return false;
 	}
 
+	m_buffer_size = buffer_size;
+	m_periods_since_underrun = 0;
+	m_telemetry.SetBufferFrames((u32)buffer_size);
+	if (m_low_latency)
+		SetFillTarget(LOW_LATENCY_MIN_PERIODS * frames_to_deliver);
+
 	err = snd_pcm_prepare(handle);
 	if (err < 0)
 	{
@@ -223,6 +291,24 @@ bool AlsaSound::AlsaInit()
 	return true;
 }
 
+// Wakes the audio thread once the device has less than the target queued, so that the
+// buffer never holds more than the target plus the period being written.
+void AlsaSound::SetFillTarget(snd_pcm_uframes_t frames)
+{
+	frames = std::min(std::max<snd_pcm_uframes_t>(frames, frames_to_deliver), m_buffer_size);
+	m_fill_target = frames;
+
+	snd_pcm_sw_params_t *swparams;
+	snd_pcm_sw_params_alloca(&swparams);
+	int err = snd_pcm_sw_params_current(handle, swparams);
+	if (err >= 0)
+		err = snd_pcm_sw_params_set_avail_min(handle, swparams, m_buffer_size - frames + frames_to_deliver);
+	if (err >= 0)
+		err = snd_pcm_sw_params(handle, swparams);
+	if (err < 0)
+		ERROR_LOG(AUDIO, "cannot set fill target: %s", snd_strerror(err));
+}
+
 void AlsaSound::AlsaShutdown()
 {
 	if (handle != nullptr)
@@ -43,6 +43,12 @@ private:
 	// number of channels per frame
 	static constexpr u32 CHANNEL_COUNT = 2;
 
+	// In low latency mode, frames per transfer, the number of periods kept queued to start
+	// with and how many periods without underrun it takes to try one period less again.
+	static constexpr u32 LOW_LATENCY_PERIOD_FRAMES = 128;
+	static constexpr u32 LOW_LATENCY_MIN_PERIODS = 2;
+	static constexpr u32 LOW_LATENCY_DECAY_PERIODS = 2000;
+
 	enum class ALSAThreadStatus
 	{
 		RUNNING,
@@ -53,6 +59,7 @@ private:
 
 	bool AlsaInit();
 	void AlsaShutdown();
+	void SetFillTarget(snd_pcm_uframes_t frames);
 
 	s16 mix_buffer[BUFFER_SIZE_MAX * CHANNEL_COUNT];
 	std::thread thread;
@@ -62,5 +69,10 @@ private:
 
 	snd_pcm_t *handle;
 	unsigned int frames_to_deliver;
+
+	bool m_low_latency;
+	snd_pcm_uframes_t m_buffer_size;
+	snd_pcm_uframes_t m_fill_target;
+	u32 m_periods_since_underrun;
 #endif
 };
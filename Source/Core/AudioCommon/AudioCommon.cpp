@@ -21,6 +21,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/Movie.h"
 
 // This shouldn't be a global, at least not here.
@@ -98,6 +99,7 @@ void ShutdownSoundStream()
 			StopAudioDump();
 		delete g_sound_stream;
 		g_sound_stream = nullptr;
+		Core::SetAudioStats("");
 	}
 
 	INFO_LOG(DSPHLE, "Done shutting down sound stream");
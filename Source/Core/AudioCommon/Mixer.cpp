@@ -3,10 +3,14 @@
 // Refer to the license.txt file included.
 // Modified For Ishiiruka By Tino
 
+#include <algorithm>
+#include <cinttypes>
+
 #include "AudioCommon/AudioCommon.h"
 #include "AudioCommon/Mixer.h"
 #include "Common/Atomic.h"
 #include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
 #include "Common/MathUtil.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -23,6 +27,7 @@
 const float CMixer::MAX_FREQ_SHIFT = 200;
 const float CMixer::CONTROL_FACTOR = 0.2f;
 const float CMixer::CONTROL_AVG = 32;
+const float CMixer::LOW_LATENCY_CONTROL_AVG = 8;
 
 CMixer::CMixer(u32 BackendSampleRate)
 	: m_dma_mixer(this, 32000)
@@ -36,41 +41,122 @@ CMixer::CMixer(u32 BackendSampleRate)
 	INFO_LOG(AUDIO_INTERFACE, "Mixer is initialized");
 }
 
-void CMixer::LinearMixerFifo::Interpolate(u32 left_input_index, float* left_output, float* right_output)
+CMixer::~CMixer()
 {
-	*left_output = (1 - m_fraction) * m_float_buffer[left_input_index & INDEX_MASK]
-		+ m_fraction * m_float_buffer[(left_input_index + 2) & INDEX_MASK];
-	*right_output = (1 - m_fraction) * m_float_buffer[(left_input_index + 1) & INDEX_MASK]
-		+ m_fraction * m_float_buffer[(left_input_index + 3) & INDEX_MASK];
+	if (m_mix_calls)
+	{
+		INFO_LOG(AUDIO_INTERFACE, "Mixer: %" PRIu64 " callbacks, %" PRIu64 " us average, %" PRIu64 " us max",
+		         m_mix_calls, m_mix_ns_total / m_mix_calls / 1000, m_mix_ns_max / 1000);
+	}
 }
 
-void CMixer::CubicMixerFifo::Interpolate(u32 left_input_index, float* left_output, float* right_output)
+#ifdef _M_X86
+// Gathers one tap of a block: the input samples at indices[i] + offset.
+static inline __m128 GatherBlock(const float* buffer, const u32* indices, u32 offset)
 {
-	static const float cubic_coef[] =
+	return _mm_setr_ps(buffer[(indices[0] + offset) & CMixer::INDEX_MASK],
+	                   buffer[(indices[1] + offset) & CMixer::INDEX_MASK],
+	                   buffer[(indices[2] + offset) & CMixer::INDEX_MASK],
+	                   buffer[(indices[3] + offset) & CMixer::INDEX_MASK]);
+}
+
+// Applies the volume and adds a full block to the interleaved right/left output.
+static inline void AddBlock(float* output, __m128 left, __m128 right, float l_volume, float r_volume)
+{
+	left = _mm_mul_ps(left, _mm_set1_ps(l_volume));
+	right = _mm_mul_ps(right, _mm_set1_ps(r_volume));
+	_mm_storeu_ps(output, _mm_add_ps(_mm_loadu_ps(output), _mm_unpacklo_ps(right, left)));
+	_mm_storeu_ps(output + 4, _mm_add_ps(_mm_loadu_ps(output + 4), _mm_unpackhi_ps(right, left)));
+}
+#endif
+
+void CMixer::LinearMixerFifo::InterpolateBlock(const u32* indices, const float* fractions, u32 count,
+                                               float* output, float l_volume, float r_volume)
+{
+#ifdef _M_X86
+	if (count == BLOCK_FRAMES)
+	{
+		const float* buffer = m_float_buffer.data();
+		const __m128 x = _mm_loadu_ps(fractions);
+		const __m128 y0 = _mm_sub_ps(_mm_set1_ps(1.0f), x);
+		__m128 left = _mm_add_ps(_mm_mul_ps(y0, GatherBlock(buffer, indices, 0)), _mm_mul_ps(x, GatherBlock(buffer, indices, 2)));
+		__m128 right = _mm_add_ps(_mm_mul_ps(y0, GatherBlock(buffer, indices, 1)), _mm_mul_ps(x, GatherBlock(buffer, indices, 3)));
+		AddBlock(output, left, right, l_volume, r_volume);
+		return;
+	}
+#endif
+	for (u32 i = 0; i < count; i++)
 	{
-	  -0.5f, 1.0f, -0.5f, 0.0f,
-	  1.5f, -2.5f, 0.0f, 1.0f,
-	  -1.5f, 2.0f, 0.5f, 0.0f,
-	  0.5f, -0.5f, 0.0f, 0.0f
-	};
-
-	const float x2 = m_fraction;		// x
-	const float x1 = x2*x2;          // x^2
-	const float x0 = x1*x2;          // x^3
-
-	float y0 = cubic_coef[0] * x0 + cubic_coef[1] * x1 + cubic_coef[2] * x2 + cubic_coef[3];
-	float y1 = cubic_coef[4] * x0 + cubic_coef[5] * x1 + cubic_coef[6] * x2 + cubic_coef[7];
-	float y2 = cubic_coef[8] * x0 + cubic_coef[9] * x1 + cubic_coef[10] * x2 + cubic_coef[11];
-	float y3 = cubic_coef[12] * x0 + cubic_coef[13] * x1 + cubic_coef[14] * x2 + cubic_coef[15];
-
-	*left_output = y0 * m_float_buffer[left_input_index & INDEX_MASK]
-		+ y1 * m_float_buffer[(left_input_index + 2) & INDEX_MASK]
-		+ y2 * m_float_buffer[(left_input_index + 4) & INDEX_MASK]
-		+ y3 * m_float_buffer[(left_input_index + 6) & INDEX_MASK];
-	*right_output = y0 * m_float_buffer[(left_input_index + 1) & INDEX_MASK]
-		+ y1 * m_float_buffer[(left_input_index + 3) & INDEX_MASK]
-		+ y2 * m_float_buffer[(left_input_index + 5) & INDEX_MASK]
-		+ y3 * m_float_buffer[(left_input_index + 7) & INDEX_MASK];
+		const u32 index = indices[i];
+		const float fraction = fractions[i];
+		float left = (1 - fraction) * m_float_buffer[index & INDEX_MASK]
+			+ fraction * m_float_buffer[(index + 2) & INDEX_MASK];
+		float right = (1 - fraction) * m_float_buffer[(index + 1) & INDEX_MASK]
+			+ fraction * m_float_buffer[(index + 3) & INDEX_MASK];
+		output[i * 2 + 1] += l_volume * left;
+		output[i * 2] += r_volume * right;
+	}
+}
+
+static const float cubic_coef[] =
+{
+  -0.5f, 1.0f, -0.5f, 0.0f,
+  1.5f, -2.5f, 0.0f, 1.0f,
+  -1.5f, 2.0f, 0.5f, 0.0f,
+  0.5f, -0.5f, 0.0f, 0.0f
+};
+
+void CMixer::CubicMixerFifo::InterpolateBlock(const u32* indices, const float* fractions, u32 count,
+                                              float* output, float l_volume, float r_volume)
+{
+#ifdef _M_X86
+	if (count == BLOCK_FRAMES)
+	{
+		// Same as below, for four frames at once
+		const float* buffer = m_float_buffer.data();
+		const __m128 x2 = _mm_loadu_ps(fractions);
+		const __m128 x1 = _mm_mul_ps(x2, x2);
+		const __m128 x0 = _mm_mul_ps(x1, x2);
+
+		__m128 left = _mm_setzero_ps();
+		__m128 right = _mm_setzero_ps();
+		for (u32 tap = 0; tap < 4; tap++)
+		{
+			const float* coef = &cubic_coef[tap * 4];
+			__m128 y = _mm_mul_ps(_mm_set1_ps(coef[0]), x0);
+			y = _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(coef[1]), x1));
+			y = _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(coef[2]), x2));
+			y = _mm_add_ps(y, _mm_set1_ps(coef[3]));
+			left = _mm_add_ps(left, _mm_mul_ps(y, GatherBlock(buffer, indices, tap * 2)));
+			right = _mm_add_ps(right, _mm_mul_ps(y, GatherBlock(buffer, indices, tap * 2 + 1)));
+		}
+		AddBlock(output, left, right, l_volume, r_volume);
+		return;
+	}
+#endif
+	for (u32 i = 0; i < count; i++)
+	{
+		const u32 index = indices[i];
+		const float x2 = fractions[i];  // x
+		const float x1 = x2*x2;          // x^2
+		const float x0 = x1*x2;          // x^3
+
+		float y0 = cubic_coef[0] * x0 + cubic_coef[1] * x1 + cubic_coef[2] * x2 + cubic_coef[3];
+		float y1 = cubic_coef[4] * x0 + cubic_coef[5] * x1 + cubic_coef[6] * x2 + cubic_coef[7];
+		float y2 = cubic_coef[8] * x0 + cubic_coef[9] * x1 + cubic_coef[10] * x2 + cubic_coef[11];
+		float y3 = cubic_coef[12] * x0 + cubic_coef[13] * x1 + cubic_coef[14] * x2 + cubic_coef[15];
+
+		float left = y0 * m_float_buffer[index & INDEX_MASK]
+			+ y1 * m_float_buffer[(index + 2) & INDEX_MASK]
+			+ y2 * m_float_buffer[(index + 4) & INDEX_MASK]
+			+ y3 * m_float_buffer[(index + 6) & INDEX_MASK];
+		float right = y0 * m_float_buffer[(index + 1) & INDEX_MASK]
+			+ y1 * m_float_buffer[(index + 3) & INDEX_MASK]
+			+ y2 * m_float_buffer[(index + 5) & INDEX_MASK]
+			+ y3 * m_float_buffer[(index + 7) & INDEX_MASK];
+		output[i * 2 + 1] += l_volume * left;
+		output[i * 2] += r_volume * right;
+	}
 }
 
 void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framelimit)
@@ -80,17 +166,24 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 	u32 read_index = m_read_index.load();
 	const u32 write_index = m_write_index.load();
 	// Sync input rate by fifo size
+	// In low latency mode, steer towards a nearly empty FIFO and react faster.
+	const bool low_latency = SConfig::GetInstance().bLowLatencyAudio;
+	const float control_avg = low_latency ? LOW_LATENCY_CONTROL_AVG : CONTROL_AVG;
 	float num_left = (float)(((write_index - read_index) & INDEX_MASK) / 2);
-	m_num_left_i = (num_left + m_num_left_i * (CONTROL_AVG - 1)) / CONTROL_AVG;
+	m_num_left_i = (num_left + m_num_left_i * (control_avg - 1)) / control_avg;
 
-	u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
+	const u32 input_sample_rate = m_input_sample_rate.load();
+	u32 buffer_ms = SConfig::GetInstance().iTimingVariance;
+	if (low_latency && buffer_ms > LOW_LATENCY_BUFFER_MS)
+		buffer_ms = LOW_LATENCY_BUFFER_MS;
+	u32 low_waterwark = input_sample_rate * buffer_ms / 1000;
 	low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
 
 	float offset = (m_num_left_i - low_waterwark) * CONTROL_FACTOR;
 	offset = MathUtil::Clamp(offset, -MAX_FREQ_SHIFT, MAX_FREQ_SHIFT);
 	// adjust framerate with framelimit
 	float emulationspeed = SConfig::GetInstance().m_EmulationSpeed;
-	float aid_sample_rate = m_input_sample_rate + offset;
+	float aid_sample_rate = input_sample_rate + offset;
 	if (consider_framelimit && emulationspeed > 0.0f)
 	{
 		aid_sample_rate = aid_sample_rate * emulationspeed;
@@ -107,15 +200,26 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 	// increment input sample position by ratio, store fraction
 	// QUESTION: do we need to check for NUM_CROSSINGS samples before we interpolate?
 	// seems to work fine as is
-	for (; current_sample < numSamples * 2 && ((write_index - read_index) & INDEX_MASK) > GetWindowSize(); current_sample += 2)
+	const u32 window_size = GetWindowSize();
+	u32 indices[BLOCK_FRAMES];
+	float fractions[BLOCK_FRAMES];
+	while (current_sample < numSamples * 2)
 	{
-		float l_output, r_output;
-		Interpolate(read_index, &l_output, &r_output);
-		samples[current_sample + 1] += l_volume * l_output;
-		samples[current_sample] += r_volume * r_output;
-		m_fraction += ratio;
-		read_index += 2 * (s32)m_fraction;
-		m_fraction = m_fraction - (s32)m_fraction;
+		// Step through the input for a block of output frames, then resample them together
+		u32 count = 0;
+		for (; count < BLOCK_FRAMES && current_sample + count * 2 < numSamples * 2 &&
+		       ((write_index - read_index) & INDEX_MASK) > window_size; count++)
+		{
+			indices[count] = read_index;
+			fractions[count] = m_fraction;
+			m_fraction += ratio;
+			read_index += 2 * (s32)m_fraction;
+			m_fraction = m_fraction - (s32)m_fraction;
+		}
+		if (count == 0)
+			break;
+		InterpolateBlock(indices, fractions, count, samples + current_sample, l_volume, r_volume);
+		current_sample += count * 2;
 	}
 	// pad output if not enough input samples
 	float s[2];
@@ -132,7 +236,7 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 
 u32 CMixer::MixerFifo::AvailableSamples()
 {
-	return ((m_write_index.load() - m_read_index.load()) & INDEX_MASK) * 48000 / (2 * m_input_sample_rate);
+	return ((m_write_index.load() - m_read_index.load()) & INDEX_MASK) * 48000 / (2 * m_input_sample_rate.load());
 }
 
 u32 CMixer::AvailableSamples()
@@ -153,8 +257,9 @@ u32 CMixer::Mix(s16* samples, u32 num_samples, bool consider_framelimit)
 {
 	if (!samples)
 		return 0;
-	std::lock_guard<std::mutex> lk(m_cs_mixing);
-	if (PowerPC::GetState() != PowerPC::CPU_RUNNING)
+	auto start = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lk(m_cs_mixing, std::try_to_lock);
+	if (!lk.owns_lock() || PowerPC::GetState() != PowerPC::CPU_RUNNING)
 	{
 		// Silence
 		memset(samples, 0, num_samples * 2 * sizeof(s16));
@@ -176,6 +281,7 @@ u32 CMixer::Mix(s16* samples, u32 num_samples, bool consider_framelimit)
 		samples[i] = s16(r_output);
 		samples[i + 1] = s16(l_output);
 	}
+	UpdateMixTime(start);
 	return num_samples;
 }
 
@@ -183,19 +289,29 @@ u32 CMixer::Mix(float* samples, u32 num_samples, bool consider_framelimit)
 {
 	if (!samples)
 		return 0;
-	std::lock_guard<std::mutex> lk(m_cs_mixing);
+	auto start = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lk(m_cs_mixing, std::try_to_lock);
 	memset(samples, 0, num_samples * 2 * sizeof(float));
-	if (PowerPC::GetState() != PowerPC::CPU_RUNNING)
+	if (!lk.owns_lock() || PowerPC::GetState() != PowerPC::CPU_RUNNING)
 	{
-		// Silence		
+		// Silence
 		return num_samples;
 	}
 	m_dma_mixer.Mix(samples, num_samples, consider_framelimit);
 	m_streaming_mixer.Mix(samples, num_samples, consider_framelimit);
 	m_wiimote_speaker_mixer.Mix(samples, num_samples, consider_framelimit);
+	UpdateMixTime(start);
 	return num_samples;
 }
 
+void CMixer::UpdateMixTime(std::chrono::steady_clock::time_point start)
+{
+	u64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	m_mix_calls++;
+	m_mix_ns_total += ns;
+	m_mix_ns_max = std::max(m_mix_ns_max, ns);
+}
+
 
 void CMixer::MixerFifo::PushSamples(const s16* samples, u32 num_samples)
 {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstring>
 #include <array>
 #include <mutex>
@@ -28,10 +29,16 @@ public:
 	static const float MAX_FREQ_SHIFT;
 	static const float CONTROL_FACTOR;
 	static const float CONTROL_AVG;
+	// Low latency mode: fill level the FIFOs are steered towards, and how fast
+	static const u32 LOW_LATENCY_BUFFER_MS = 5;
+	static const float LOW_LATENCY_CONTROL_AVG;
+	// Output frames resampled per iteration
+	static const u32 BLOCK_FRAMES = 4;
 
-	virtual ~CMixer() {}
+	virtual ~CMixer();
 
-	// Called from audio threads
+	// Called from audio threads. Never blocks: while the mixer is locked (see MixerCritical),
+	// silence is returned instead.
 	u32 Mix(s16* samples, u32 numSamples, bool consider_framelimit = true);
 	u32 Mix(float* samples, u32 numSamples, bool consider_framelimit = true);
 	u32 AvailableSamples();
@@ -75,7 +82,10 @@ protected:
 			m_float_buffer.fill(0.0f);
 		}
 		virtual u32 GetWindowSize() = 0;
-		virtual void Interpolate(u32 left_input_index, float* left_output, float* right_output) = 0;
+		// Resamples count (at most BLOCK_FRAMES) stereo frames starting at the given input
+		// indices and adds them, scaled by the volume, to the interleaved right/left output.
+		virtual void InterpolateBlock(const u32* indices, const float* fractions, u32 count,
+		                              float* output, float l_volume, float r_volume) = 0;
 		void PushSamples(const s16* samples, u32 num_samples);
 		void Mix(float* samples, u32 numSamples, bool consider_framelimit = true);
 		void SetInputSampleRate(u32 rate);
@@ -84,7 +94,7 @@ protected:
 		u32 AvailableSamples();
 	protected:
 		CMixer *m_mixer;
-		unsigned m_input_sample_rate;
+		std::atomic<u32> m_input_sample_rate;
 
 		std::array<float, MAX_SAMPLES * 2> m_float_buffer;
 
@@ -103,7 +113,8 @@ protected:
 	{
 	public:
 		LinearMixerFifo(CMixer* mixer, u32 sample_rate) : MixerFifo(mixer, sample_rate) {}
-		void Interpolate(u32 left_input_index, float* left_output, float* right_output) override;
+		void InterpolateBlock(const u32* indices, const float* fractions, u32 count,
+		                      float* output, float l_volume, float r_volume) override;
 		u32 GetWindowSize() override { return 4; };
 	};
 
@@ -111,7 +122,8 @@ protected:
 	{
 	public:
 		CubicMixerFifo(CMixer* mixer, u32 sample_rate) : MixerFifo(mixer, sample_rate) {}
-		void Interpolate(u32 left_input_index, float* left_output, float* right_output) override;
+		void InterpolateBlock(const u32* indices, const float* fractions, u32 count,
+		                      float* output, float l_volume, float r_volume) override;
 		u32 GetWindowSize() override { return 8; };
 	};
 
@@ -135,7 +147,13 @@ protected:
 	std::atomic<float> m_speed; // Current rate of the emulation (1.0 = 100% speed)
 
 private:
+	void UpdateMixTime(std::chrono::steady_clock::time_point start);
 
 	std::vector<float> m_output_buffer;
+
+	// Time spent in Mix, logged when the mixer goes away. Only touched by the audio thread.
+	u64 m_mix_calls = 0;
+	u64 m_mix_ns_total = 0;
+	u64 m_mix_ns_max = 0;
 };
 
@@ -14,17 +14,27 @@
 namespace
 {
 const size_t BUFFER_SAMPLES = 512; // ~10 ms - needs to be at least 240 for surround
+// Low latency mode starts at ~3 ms and grows in ~1.3 ms steps on underflows.
+const size_t LOW_LATENCY_BUFFER_SAMPLES = 128;
+const size_t LOW_LATENCY_STEP_SAMPLES = 64;
+// Frames played without underflow before the latency is lowered again, ~10 s.
+const u32 LOW_LATENCY_DECAY_FRAMES = 48000 * 10;
 }
 
 PulseAudio::PulseAudio()
 	: m_thread()
 	, m_run_thread()
+	, m_low_latency(false)
+	, m_tlength_min(0)
+	, m_tlength_step(0)
+	, m_frames_since_underflow(0)
 {
 }
 
 bool PulseAudio::Start()
 {
 	m_stereo = !SConfig::GetInstance().bDPL2Decoder;
+	m_low_latency = SConfig::GetInstance().bLowLatencyAudio;
 	m_channels = m_stereo ? 2 : 5; // will tell PA we use a Stereo or 5.0 channel setup
 
 	NOTICE_LOG(AUDIO, "PulseAudio backend using %d channels", m_channels);
@@ -122,11 +132,24 @@ bool PulseAudio::PulseInit()
 
 	// connect this audio stream to the default audio playback
 	// limit buffersize to reduce latency
+	const u32 bytes_per_frame = m_channels * m_bytespersample;
 	m_pa_ba.fragsize = -1;
 	m_pa_ba.maxlength = -1;          // max buffer, so also max latency
 	m_pa_ba.minreq = -1;             // don't read every byte, try to group them _a bit_
 	m_pa_ba.prebuf = -1;             // start as early as possible
-	m_pa_ba.tlength = BUFFER_SAMPLES * m_channels * m_bytespersample; // designed latency, only change this flag for low latency output
+	m_pa_ba.tlength = BUFFER_SAMPLES * bytes_per_frame; // designed latency, only change this flag for low latency output
+	m_tlength_step = BUFFER_SAMPLES * bytes_per_frame;
+	if (m_low_latency)
+	{
+		// surround needs at least 240 frames per request for the DPL2 decoder
+		size_t buffer_samples = m_stereo ? LOW_LATENCY_BUFFER_SAMPLES : 256;
+		m_pa_ba.tlength = buffer_samples * bytes_per_frame;
+		m_pa_ba.minreq = buffer_samples / 2 * bytes_per_frame;
+		m_tlength_step = LOW_LATENCY_STEP_SAMPLES * bytes_per_frame;
+	}
+	m_tlength_min = m_pa_ba.tlength;
+	m_frames_since_underflow = 0;
+	m_telemetry.SetBufferFrames(m_pa_ba.tlength / bytes_per_frame);
 	pa_stream_flags flags = pa_stream_flags(PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_ADJUST_LATENCY | PA_STREAM_AUTO_TIMING_UPDATE);
 	m_pa_error = pa_stream_connect_playback(m_pa_s, nullptr, &m_pa_ba, flags, nullptr, nullptr);
 	if (m_pa_error < 0)
@@ -162,10 +185,13 @@ void PulseAudio::StateCallback(pa_context* c)
 		break;
 	}
 }
-// on underflow, increase pulseaudio latency in ~10ms steps
+// on underflow, increase pulseaudio latency in ~10ms steps (smaller ones in low latency mode)
 void PulseAudio::UnderflowCallback(pa_stream* s)
 {
-	m_pa_ba.tlength += BUFFER_SAMPLES * m_channels * m_bytespersample;
+	m_telemetry.OnUnderrun();
+	m_frames_since_underflow = 0;
+	m_pa_ba.tlength += m_tlength_step;
+	m_telemetry.SetBufferFrames(m_pa_ba.tlength / (m_channels * m_bytespersample));
 	pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
 	pa_operation_unref(op);
 
@@ -228,6 +254,23 @@ void PulseAudio::WriteCallback(pa_stream* s, size_t length)
 	}
 
 	m_pa_error = pa_stream_write(s, buffer, trunc_length, nullptr, 0, PA_SEEK_RELATIVE);
+
+	pa_usec_t latency;
+	int negative;
+	if (pa_stream_get_latency(s, &latency, &negative) == 0 && !negative)
+		m_telemetry.OnWrite((u32)(latency * m_mixer->GetSampleRate() / 1000000));
+
+	// Give back one step of latency once the stream has been stable for a while.
+	m_frames_since_underflow += frames;
+	if (m_low_latency && m_frames_since_underflow >= LOW_LATENCY_DECAY_FRAMES &&
+	    m_pa_ba.tlength >= m_tlength_min + m_tlength_step)
+	{
+		m_frames_since_underflow = 0;
+		m_pa_ba.tlength -= m_tlength_step;
+		m_telemetry.SetBufferFrames(m_pa_ba.tlength / bytes_per_frame);
+		pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
+		pa_operation_unref(op);
+	}
 }
 
 // Callbacks that forward to internal methods (required because PulseAudio is a C API).
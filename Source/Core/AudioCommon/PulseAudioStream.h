@@ -55,5 +55,10 @@ private:
 	pa_context *m_pa_ctx;
 	pa_stream *m_pa_s;
 	pa_buffer_attr m_pa_ba;
+
+	bool m_low_latency;
+	u32 m_tlength_min;
+	u32 m_tlength_step;
+	u32 m_frames_since_underflow;
 #endif
 };
@@ -24,6 +24,7 @@
 #include "AudioCommon/DPL2Decoder.h"
 
 #include "Common/MathUtil.h"
+#include "Common/StringUtil.h"
 
 SoundStream::SoundStream() : m_enablesoundloop(true), m_mixer(new CMixer(48000)), threadData(true), m_logAudio(false), m_muted(false)
 {
@@ -57,6 +58,43 @@ void SoundStream::StopLogAudio() {
 		WARN_LOG(AUDIO, "Audio logging already stopped");
 	}
 }
+void SoundStreamTelemetry::OnWrite(u32 queued_frames)
+{
+	auto now = std::chrono::steady_clock::now();
+	if (m_writes.load() != 0)
+	{
+		// Exponential moving averages of the interval and of its deviation
+		float interval = (float)std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_write).count();
+		if (m_interval_avg_us == 0.0f)
+			m_interval_avg_us = interval;
+		m_jitter_avg_us += (std::abs(interval - m_interval_avg_us) - m_jitter_avg_us) / 16.0f;
+		m_interval_avg_us += (interval - m_interval_avg_us) / 16.0f;
+		m_interval_us.store((u32)m_interval_avg_us);
+		m_jitter_us.store((u32)m_jitter_avg_us);
+	}
+	m_last_write = now;
+	m_queued_frames.store(queued_frames);
+	m_writes++;
+
+	// The overlay only redraws at the frame rate, so there is no point formatting more often
+	if (now - m_last_publish >= std::chrono::milliseconds(250))
+	{
+		m_last_publish = now;
+		Core::SetAudioStats(ToString());
+	}
+}
+
+std::string SoundStreamTelemetry::ToString() const
+{
+	if (m_writes.load() == 0)
+		return "";
+	return StringFromFormat("Audio interval: %.2f ms (jitter %.2f ms)\n"
+	                        "Audio queued: %u / %u frames\n"
+	                        "Audio underruns: %u\n",
+	                        m_interval_us.load() / 1000.0f, m_jitter_us.load() / 1000.0f,
+	                        m_queued_frames.load(), m_buffer_frames.load(), m_underruns.load());
+}
+
 bool SoundStream::Start()
 {
 	if (m_enablesoundloop)
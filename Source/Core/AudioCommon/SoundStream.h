@@ -4,7 +4,9 @@
 
 #pragma once
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <string>
 
 #include "AudioCommon/Mixer.h"
 #include "AudioCommon/WaveFile.h"
@@ -25,6 +27,34 @@
 #define SOUND_MAX_FRAME_SIZE_BYTES (SOUND_MAX_FRAME_SIZE * sizeof(s16))
 #define SOUND_BUFFER_COUNT 3u
 
+// Output timing reported by backends that drive the device themselves, shown in the
+// statistics overlay. Updated on the audio thread, read from anywhere.
+class SoundStreamTelemetry
+{
+public:
+	// Call each time a block was handed to the device, with the frames it has queued.
+	// Publishes the statistics for the overlay every now and then.
+	void OnWrite(u32 queued_frames);
+	void OnUnderrun() { m_underruns++; }
+	void SetBufferFrames(u32 frames) { m_buffer_frames.store(frames); }
+
+	// Empty until the backend has reported anything.
+	std::string ToString() const;
+
+private:
+	std::chrono::steady_clock::time_point m_last_write;
+	std::chrono::steady_clock::time_point m_last_publish;
+	float m_interval_avg_us = 0.0f;
+	float m_jitter_avg_us = 0.0f;
+
+	std::atomic<u32> m_writes{0};
+	std::atomic<u32> m_interval_us{0};
+	std::atomic<u32> m_jitter_us{0};
+	std::atomic<u32> m_underruns{0};
+	std::atomic<u32> m_queued_frames{0};
+	std::atomic<u32> m_buffer_frames{0};
+};
+
 class SoundStream
 {
 protected:
@@ -35,6 +65,7 @@ protected:
 	WaveFileWriter g_wave_writer;
 	bool m_muted;
 	std::unique_ptr<std::thread> thread;
+	SoundStreamTelemetry m_telemetry;
 	virtual void SoundLoop();
 	virtual void InitializeSoundLoop() {}
 	virtual u32 SamplesNeeded(){ return 0; }
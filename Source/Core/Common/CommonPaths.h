@@ -102,9 +102,13 @@
 #define ARAM_DUMP     "aram.raw"
 #define FAKEVMEM_DUMP "fakevmem.raw"
 
+// Files in the directory returned by GetUserPath(D_CACHE_IDX)
+#define MOVIE_MD5_CACHE "MovieMD5.txt"
+
 // Files in the directory returned by GetUserPath(D_MEMORYWATCHER_IDX)
 #define MEMORYWATCHER_LOCATIONS "Locations.txt"
 #define MEMORYWATCHER_SOCKET    "MemoryWatcher"
+#define MEMORYWATCHER_SHM       "MemoryWatcher.shm"
 
 // Sys files
 #define TOTALDB     "totaldb.dsy"
@@ -9,6 +9,9 @@
 #include "Common/Hash.h"
 #include "Common/Intrinsics.h"
 
+#define XXH_STATIC_LINKING_ONLY
+#include <xxhash.h>
+
 static u64 (*ptrHashFunction)(const u8* src, u32 len, u32 samples) = &GetMurmurHash3;
 
 // uint32_t
@@ -576,6 +579,108 @@ u64 GetHashHiresTexture(const u8* src, u32 len, u32 samples)
 }
 #endif
 
+//-----------------------------------------------------------------------------
+// XXH3 (xxHash XXH3_64bits, seed 0) from Externals/xxhash.
+// With samples == 0 the result is identical to the reference implementation.
+// Otherwise only `samples` evenly spaced 64-byte stripes of the input are
+// hashed, like the sampled variants of the other hashes.
+
+static const u32 XXH3_STRIPE_LEN = 64;
+
+namespace
+{
+struct XXH3Functions
+{
+	XXH64_hash_t (*hash)(const void* input, size_t length);
+	XXH_errorcode (*reset)(XXH3_state_t* state);
+	XXH_errorcode (*update)(XXH3_state_t* state, const void* input, size_t length);
+	XXH64_hash_t (*digest)(const XXH3_state_t* state);
+};
+}
+
+#ifdef _M_X86_64
+// Externals/xxhash/xxhash_avx2.c, the same functions built with the AVX2 kernels
+extern "C"
+{
+XXH64_hash_t XXH_avx2_XXH3_64bits(const void* input, size_t length);
+XXH_errorcode XXH_avx2_XXH3_64bits_reset(XXH3_state_t* state);
+XXH_errorcode XXH_avx2_XXH3_64bits_update(XXH3_state_t* state, const void* input, size_t length);
+XXH64_hash_t XXH_avx2_XXH3_64bits_digest(const XXH3_state_t* state);
+}
+
+static const XXH3Functions s_xxh3_avx2 = {
+	&XXH_avx2_XXH3_64bits, &XXH_avx2_XXH3_64bits_reset,
+	&XXH_avx2_XXH3_64bits_update, &XXH_avx2_XXH3_64bits_digest };
+#endif
+
+static const XXH3Functions s_xxh3_default = {
+	&XXH3_64bits, &XXH3_64bits_reset, &XXH3_64bits_update, &XXH3_64bits_digest };
+
+static const XXH3Functions& GetXXH3Functions()
+{
+#ifdef _M_X86_64
+	if (cpu_info.bAVX2)
+		return s_xxh3_avx2;
+#endif
+	return s_xxh3_default;
+}
+
+static u32 XXH3SampleStep(u32 stripes, u32 samples)
+{
+	if (samples == 0 || samples >= stripes)
+		return 1;
+	return stripes / samples;
+}
+
+u64 GetXXH3Hash64(const u8* src, u32 len, u32 samples)
+{
+	const XXH3Functions& xxh3 = GetXXH3Functions();
+	u32 stripes = len / XXH3_STRIPE_LEN;
+	u32 step = XXH3SampleStep(stripes, samples);
+	if (step == 1)
+		return xxh3.hash(src, len);
+
+	XXH3_state_t state;
+	xxh3.reset(&state);
+	for (u32 i = 0; i < stripes; i += step)
+		xxh3.update(&state, src + i * XXH3_STRIPE_LEN, XXH3_STRIPE_LEN);
+	return xxh3.digest(&state);
+}
+
+u64 GetXXH3Hash64Strided(const u8* src, u32 row_len, u32 stride, u32 rows, u32 samples)
+{
+	if (stride == row_len || rows <= 1)
+		return GetXXH3Hash64(src, row_len * rows, samples);
+
+	// Streaming the rows gives the same result as hashing them back to back.
+	const XXH3Functions& xxh3 = GetXXH3Functions();
+	XXH3_state_t state;
+	xxh3.reset(&state);
+	u32 step = XXH3SampleStep(row_len * rows / XXH3_STRIPE_LEN, samples);
+	if (step == 1)
+	{
+		for (u32 y = 0; y < rows; y++)
+			xxh3.update(&state, src + y * stride, row_len);
+		return xxh3.digest(&state);
+	}
+
+	u32 skip = 0;
+	for (u32 y = 0; y < rows; y++)
+	{
+		const u8* row = src + y * stride;
+		for (u32 x = 0; x < row_len; x += XXH3_STRIPE_LEN)
+		{
+			if (skip == 0)
+			{
+				xxh3.update(&state, row + x, std::min(XXH3_STRIPE_LEN, row_len - x));
+				skip = step;
+			}
+			skip--;
+		}
+	}
+	return xxh3.digest(&state);
+}
+
 u64 GetHash64(const u8* src, u32 len, u32 samples)
 {
 	return ptrHashFunction(src, len, samples);
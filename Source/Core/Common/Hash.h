@@ -15,4 +15,6 @@ u64 GetCRC32(const u8* src, u32 len, u32 samples);   // SSE4.2 version of CRC32
 u64 GetHashHiresTexture(const u8* src, u32 len, u32 samples = 0);
 u64 GetMurmurHash3(const u8* src, u32 len, u32 samples);
 u64 GetHash64(const u8* src, u32 len, u32 samples);
+u64 GetXXH3Hash64(const u8* src, u32 len, u32 samples);           // XXH3_64bits, SSE2/AVX2 accelerated
+u64 GetXXH3Hash64Strided(const u8* src, u32 row_len, u32 stride, u32 rows, u32 samples);
 void SetHash64Function();
@@ -28,4 +28,14 @@
 # endif
 #endif
 
+// Marks a function as using instructions beyond the build's baseline ISA.
+// Such functions may only be called after checking cpu_info at runtime.
+#ifdef _MSC_VER
+#define FUNCTION_TARGET_AVX2
+#define FUNCTION_TARGET_AES
+#else
+#define FUNCTION_TARGET_AVX2 __attribute__((target("avx2")))
+#define FUNCTION_TARGET_AES __attribute__((target("aes")))
+#endif
+
 #endif // _M_X86
@@ -70,6 +70,15 @@ void Shutdown()
 		s_perf_map_file.Close();
 }
 
+bool IsEnabled()
+{
+#if (defined USE_OPROFILE && USE_OPROFILE) || defined(USE_VTUNE)
+	return true;
+#else
+	return s_perf_map_file.IsOpen();
+#endif
+}
+
 void RegisterV(const void* base_address, u32 code_size,
 	const char* format, va_list args)
 {
@@ -12,6 +12,8 @@ namespace JitRegister
 
 void Init(const std::string& perf_dir);
 void Shutdown();
+// Whether registered code is reported anywhere, to skip building names that would be dropped.
+bool IsEnabled();
 void RegisterV(const void* base_address, u32 code_size,
 	const char* format, va_list args);
 
@@ -2,8 +2,10 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <cstdarg>
 #include <cstring>
+#include <ctime>
 #include <mutex>
 #include <ostream>
 #include <set>
@@ -12,7 +14,7 @@
 #include "Common/FileUtil.h"
 #include "Common/IniFile.h"
 #include "Common/StringUtil.h"
-#include "Common/Timer.h"
+#include "Common/Thread.h"
 #include "Common/Logging/ConsoleListener.h"
 #include "Common/Logging/Log.h"
 #include "Common/Logging/LogManager.h"
@@ -102,10 +104,22 @@ LogManager::LogManager()
 		if (enable && write_console)
 			container->AddListener(LogListener::CONSOLE_LISTENER);
 	}
+
+	m_ring.reset(new LogEntry[RING_SIZE]);
+	for (u32 i = 0; i < RING_SIZE; i++)
+		m_ring[i].sequence.store(i, std::memory_order_relaxed);
+
+	m_writer_running.Set();
+	m_writer_thread = std::thread(&LogManager::WriterThread, this);
 }
 
 LogManager::~LogManager()
 {
+	// The writer empties the ring before it exits
+	m_writer_running.Clear();
+	m_writer_wakeup.Set();
+	m_writer_thread.join();
+
 	for (LogContainer* container : m_Log)
 		delete container;
 
@@ -117,24 +131,150 @@ LogManager::~LogManager()
 void LogManager::Log(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type,
 	const char* file, int line, const char* format, va_list args)
 {
-	char temp[MAX_MSGLEN];
 	LogContainer* log = m_Log[type];
 
 	if (!log->IsEnabled() || level > log->GetLevel() || !log->HasListeners())
 		return;
 
-	CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
+	// Claim an entry, as a bounded multi-producer queue: an entry is free for position pos
+	// once its sequence is pos, it is still being read if the sequence is behind.
+	u32 pos = m_write_pos.load(std::memory_order_relaxed);
+	LogEntry* entry;
+	while (true)
+	{
+		entry = &m_ring[pos % RING_SIZE];
+		s32 diff = (s32)(entry->sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0)
+		{
+			if (m_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			// Errors wait for the writer to make room instead
+			if (level == LogTypes::LERROR && CanWaitForWriter())
+			{
+				Flush();
+				pos = m_write_pos.load(std::memory_order_relaxed);
+				continue;
+			}
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			m_writer_wakeup.Set();
+			return;
+		}
+		else
+		{
+			pos = m_write_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	// The arguments may point to temporary buffers, so only the prefix is formatted later
+	CharArrayFromFormatV(entry->text, MAX_MSGLEN, format, args);
+	entry->level = level;
+	entry->type = type;
+	entry->file = file;
+	entry->line = line;
+	entry->timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	entry->sequence.store(pos + 1, std::memory_order_release);
+
+	// An error is often the last thing logged before a panic alert, an exit or a crash, so it
+	// has been passed to the listeners when this returns, after everything queued before it.
+	if (level == LogTypes::LERROR)
+		Flush();
+	// The writer polls, only wake it early when the ring is filling up
+	else if (pos - m_read_pos.load(std::memory_order_relaxed) == RING_SIZE / 2)
+		m_writer_wakeup.Set();
+}
+
+void LogManager::WriteMessage(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file,
+                              int line, u64 timestamp, const char* text)
+{
+	LogContainer* log = m_Log[type];
+
+	time_t seconds = (time_t)(timestamp / 1000);
+	char time_str[8];
+	strftime(time_str, sizeof(time_str), "%M:%S", localtime(&seconds));
 
-	std::string msg = StringFromFormat("%s %s:%u %c[%s]: %s\n",
-	                                   Common::Timer::GetTimeFormatted().c_str(),
+	std::string msg = StringFromFormat("%s:%03u %s:%u %c[%s]: %s\n",
+	                                   time_str, (u32)(timestamp % 1000),
 	                                   file, line,
 	                                   LogTypes::LOG_LEVEL_TO_CHAR[(int)level],
-	                                   log->GetShortName().c_str(), temp);
+	                                   log->GetShortName().c_str(), text);
 
 	for (auto listener_id : *log)
 		m_listeners[listener_id]->Log(level, msg.c_str());
 }
 
+void LogManager::WriteQueuedMessages()
+{
+	u32 pos = m_read_pos.load(std::memory_order_relaxed);
+	while (true)
+	{
+		LogEntry& entry = m_ring[pos % RING_SIZE];
+		if (entry.sequence.load(std::memory_order_acquire) != pos + 1)
+			break;
+
+		WriteMessage(entry.level, entry.type, entry.file, entry.line, entry.timestamp, entry.text);
+
+		// Free the entry for the producer one lap ahead
+		entry.sequence.store(pos + RING_SIZE, std::memory_order_release);
+		m_read_pos.store(++pos, std::memory_order_release);
+	}
+
+	u32 dropped = m_dropped.load(std::memory_order_relaxed);
+	if (dropped != m_reported_dropped)
+	{
+		std::string msg = StringFromFormat("Log: dropped %u messages, the log ring was full\n",
+		                                   dropped - m_reported_dropped);
+		m_reported_dropped = dropped;
+
+		// Tell every listener that a dropped message could have been for
+		std::array<bool, LogListener::NUMBER_OF_LISTENERS> used{};
+		for (const LogContainer* container : m_Log)
+		{
+			for (auto listener_id : *container)
+				used[listener_id] = true;
+		}
+		for (int i = 0; i < LogListener::NUMBER_OF_LISTENERS; i++)
+		{
+			if (used[i])
+				m_listeners[i]->Log(LogTypes::LWARNING, msg.c_str());
+		}
+	}
+}
+
+void LogManager::WriterThread()
+{
+	Common::SetCurrentThreadName("Log writer");
+
+	while (m_writer_running.IsSet())
+	{
+		m_writer_wakeup.WaitFor(std::chrono::milliseconds(5));
+		WriteQueuedMessages();
+	}
+	WriteQueuedMessages();
+}
+
+bool LogManager::CanWaitForWriter() const
+{
+	// Not while shutting down, or from a listener
+	return m_writer_running.IsSet() && std::this_thread::get_id() != m_writer_thread.get_id();
+}
+
+void LogManager::Flush()
+{
+	if (!CanWaitForWriter())
+		return;
+
+	u32 target = m_write_pos.load();
+	while ((s32)(m_read_pos.load() - target) < 0 && m_writer_running.IsSet())
+	{
+		m_writer_wakeup.Set();
+		Common::YieldCPU();
+	}
+}
+
 void LogManager::Init()
 {
 	m_logManager = new LogManager();
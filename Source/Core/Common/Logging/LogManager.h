@@ -5,14 +5,19 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdarg>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 
 #include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/NonCopyable.h"
 #include "Common/Logging/Log.h"
 
@@ -91,15 +96,52 @@ private:
 
 class ConsoleListener;
 
+// Log calls only format the message text and queue it in a bounded lock-free ring, a writer
+// thread adds the prefix and passes it to the listeners. Messages are dropped when the ring
+// is full, the writer reports how many. Errors are written before Log returns and never dropped.
 class LogManager : NonCopyable
 {
 private:
+	struct LogEntry
+	{
+		// The write position this entry can be filled at, or the position + 1 once it is filled
+		std::atomic<u32> sequence;
+		LogTypes::LOG_LEVELS level;
+		LogTypes::LOG_TYPE type;
+		const char* file;
+		int line;
+		u64 timestamp;  // in milliseconds since 1970
+		char text[MAX_MSGLEN];
+	};
+
+	enum : u32
+	{
+		RING_SIZE = 1024,
+	};
+
 	LogContainer* m_Log[LogTypes::NUMBER_OF_LOGS];
 	static LogManager* m_logManager;  // Singleton. Ugh.
 	std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners;
 
+	std::unique_ptr<LogEntry[]> m_ring;
+	std::atomic<u32> m_write_pos{0};
+	std::atomic<u32> m_read_pos{0};
+	std::atomic<u32> m_dropped{0};
+	// Only used by the writer thread
+	u32 m_reported_dropped = 0;
+
+	Common::Flag m_writer_running;
+	Common::Event m_writer_wakeup;
+	std::thread m_writer_thread;
+
 	LogManager();
 	~LogManager();
+
+	bool CanWaitForWriter() const;
+	void WriterThread();
+	void WriteQueuedMessages();
+	void WriteMessage(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
+	                  u64 timestamp, const char* text);
 public:
 
 	static u32 GetMaxLevel() { return MAX_LOGLEVEL; }
@@ -147,6 +189,10 @@ public:
 		m_Log[type]->RemoveListener(id);
 	}
 
+	// Blocks until the messages logged so far have been passed to the listeners
+	void Flush();
+	u32 GetDroppedCount() const { return m_dropped.load(); }
+
 	static LogManager* GetInstance()
 	{
 		return m_logManager;
@@ -35,12 +35,13 @@ SConfig::SConfig()
   bJITPairedOff(false), bJITSystemRegistersOff(false),
   bJITBranchOff(false),
   bJITILTimeProfiling(false), bJITILOutputIR(false),
+  bJITHotTraces(false),
   bFPRF(false), bAccurateNaNs(false), iTimingVariance(40),
   bCPUThread(true), bDSPThread(false), bDSPHLE(true),
   bSkipIdle(true), bSyncGPUOnSkipIdleHack(true), bNTSC(false), bForceNTSCJ(false),
   bHLE_BS2(true), bEnableCheats(false),
   bEnableMemcardSdWriting(true),
-  bDPL2Decoder(false), bTimeStretching(false), bRSHACK(false), bWiiSpeakSupport(false), iLatency(14),
+  bDPL2Decoder(false), bTimeStretching(false), bRSHACK(false), bWiiSpeakSupport(false), iLatency(14), bLowLatencyAudio(false),
   bRunCompareServer(false), bRunCompareClient(false),
   bMMU(false), bDCBZOFF(false),
   iBBDumpPort(0), bDoubleVideoRate(false),
@@ -225,6 +226,7 @@ void SConfig::SaveCoreSettings(IniFile& ini)
 	core->Set("TimingVariance", iTimingVariance);
 	core->Set("CPUCore", iCPUCore);
 	core->Set("Fastmem", bFastmem);
+	core->Set("JITHotTraces", bJITHotTraces);
 	core->Set("CPUThread", bCPUThread);
 	core->Set("DSPHLE", bDSPHLE);
 	core->Set("SkipIdle", bSkipIdle);
@@ -246,6 +248,7 @@ void SConfig::SaveCoreSettings(IniFile& ini)
 	core->Set("RSHACK", bRSHACK);	
 	core->Set("WiiSpeakSupport", bWiiSpeakSupport);
 	core->Set("Latency", iLatency);
+	core->Set("LowLatencyAudio", bLowLatencyAudio);
 	core->Set("MemcardAPath", m_strMemoryCardA);
 	core->Set("MemcardBPath", m_strMemoryCardB);
 	core->Set("AgpCartAPath", m_strGbaCartA);
@@ -273,6 +276,7 @@ void SConfig::SaveCoreSettings(IniFile& ini)
 	core->Set("GFXBackend", m_strVideoBackend);
 	core->Set("GPUDeterminismMode", m_strGPUDeterminismMode);
 	core->Set("PerfMapDir", m_perfDir);
+	core->Set("MemoryWatcherMode", m_strMemoryWatcherMode);
 }
 
 void SConfig::SaveMovieSettings(IniFile& ini)
@@ -294,6 +298,7 @@ void SConfig::SaveDSPSettings(IniFile& ini)
 	dsp->Set("DumpAudio", m_DumpAudio);
 	dsp->Set("DumpUCode", m_DumpUCode);
 	dsp->Set("Backend", sBackend);
+	dsp->Set("AlsaDevice", sAlsaDevice);
 	dsp->Set("Volume", m_Volume);
 	dsp->Set("CaptureLog", m_DSPCaptureLog);
 }
@@ -303,6 +308,7 @@ void SConfig::SaveInputSettings(IniFile& ini)
 	IniFile::Section* input = ini.GetOrCreateSection("Input");
 
 	input->Set("BackgroundInput", m_BackgroundInput);
+	input->Set("PollingThread", m_InputPollingThread);
 }
 
 void SConfig::SaveFifoPlayerSettings(IniFile& ini)
@@ -486,6 +492,7 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("CPUCore",      &iCPUCore, PowerPC::CORE_INTERPRETER);
 #endif
 	core->Get("Fastmem",           &bFastmem,      true);
+	core->Get("JITHotTraces",      &bJITHotTraces, false);
 	core->Get("DSPHLE",            &bDSPHLE,       true);
 	core->Get("TimingVariance",    &iTimingVariance, 40);
 	core->Get("CPUThread",         &bCPUThread,    true);
@@ -502,6 +509,7 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("RSHACK",            &bRSHACK,         false);
 	core->Get("WiiSpeakSupport",    &bWiiSpeakSupport, false);
 	core->Get("Latency",           &iLatency, 2);
+	core->Get("LowLatencyAudio",   &bLowLatencyAudio, false);
 	core->Get("MemcardAPath",      &m_strMemoryCardA);
 	core->Get("MemcardBPath",      &m_strMemoryCardB);
 	core->Get("AgpCartAPath",      &m_strGbaCartA);
@@ -541,6 +549,7 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("GFXBackend",                &m_strVideoBackend, "");
 	core->Get("GPUDeterminismMode",        &m_strGPUDeterminismMode, "auto");
 	core->Get("PerfMapDir",                &m_perfDir, "");
+	core->Get("MemoryWatcherMode",         &m_strMemoryWatcherMode, "thread");
 }
 
 void SConfig::LoadMovieSettings(IniFile& ini)
@@ -572,6 +581,7 @@ void SConfig::LoadDSPSettings(IniFile& ini)
 #else
 	dsp->Get("Backend", &sBackend, BACKEND_NULLSOUND);
 #endif
+	dsp->Get("AlsaDevice", &sAlsaDevice, "default");
 	dsp->Get("Volume", &m_Volume, 100);
 	dsp->Get("CaptureLog", &m_DSPCaptureLog, false);
 
@@ -583,6 +593,7 @@ void SConfig::LoadInputSettings(IniFile& ini)
 	IniFile::Section* input = ini.GetOrCreateSection("Input");
 
 	input->Get("BackgroundInput", &m_BackgroundInput, false);
+	input->Get("PollingThread", &m_InputPollingThread, false);
 }
 
 void SConfig::LoadFifoPlayerSettings(IniFile& ini)
@@ -630,6 +641,7 @@ void SConfig::LoadDefaults()
 	bRSHACK = false;
 	bWiiSpeakSupport = false;
 	iLatency = 14;
+	bLowLatencyAudio = false;
 
 	iPosX = 100;
 	iPosY = 100;
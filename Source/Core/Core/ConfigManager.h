@@ -75,6 +75,8 @@ struct SConfig : NonCopyable
 	bool bJITBranchOff;
 	bool bJITILTimeProfiling;
 	bool bJITILOutputIR;
+	// Jit64: recompile hot blocks as traces across their likely branches
+	bool bJITHotTraces;
 
 	bool bFastmem;
 	bool bFPRF;
@@ -97,6 +99,7 @@ struct SConfig : NonCopyable
 	bool bRSHACK;
 	bool bWiiSpeakSupport;
 	int iLatency;
+	bool bLowLatencyAudio;
 
 	bool bRunCompareServer;
 	bool bRunCompareClient;
@@ -173,6 +176,9 @@ struct SConfig : NonCopyable
 
 	std::string m_perfDir;
 
+	// "thread", "frame" or "shm", see MemoryWatcher.h
+	std::string m_strMemoryWatcherMode;
+
 	void LoadDefaults();
 	bool AutoSetup(EBootBS2 _BootBS2);
 	const std::string &GetUniqueID() const { return m_strUniqueID; }
@@ -266,9 +272,11 @@ struct SConfig : NonCopyable
 	bool m_DumpUCode;
 	int m_Volume;
 	std::string sBackend;
+	std::string sAlsaDevice;
 
 	// Input settings
 	bool m_BackgroundInput;
+	bool m_InputPollingThread;
 	bool m_AdapterRumble[4];
 	bool m_AdapterKonga[4];
 
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <cctype>
 #include <cstring>
+#include <mutex>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -56,6 +57,7 @@
 #include "Core/IPC_HLE/WII_Socket.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 
 #ifdef USE_GDBSTUB
 #include "Core/PowerPC/GDBStub.h"
@@ -106,11 +108,14 @@ static void* s_window_handle = nullptr;
 static std::string s_state_filename;
 static std::thread s_emu_thread;
 static StoppedCallbackFunc s_on_stopped_callback = nullptr;
+static FrameCallbackFunc s_on_frame_callback = nullptr;
 
 static std::thread s_cpu_thread;
 static bool s_request_refresh_info = false;
 static int s_pause_and_lock_depth = 0;
 static bool s_is_throttler_temp_disabled = false;
+static std::mutex s_audio_stats_lock;
+static std::string s_audio_stats;
 
 #ifdef USE_MEMORYWATCHER
 static std::unique_ptr<MemoryWatcher> s_memory_watcher;
@@ -146,6 +151,14 @@ void FrameUpdateOnCPUThread()
 		NetPlayClient::SendTimeBase();
 }
 
+void FieldEndOnCPUThread()
+{
+#ifdef USE_MEMORYWATCHER
+	if (s_memory_watcher)
+		s_memory_watcher->Step();
+#endif
+}
+
 // Display messages and return values
 
 // Formatted stop message
@@ -171,6 +184,18 @@ void DisplayMessage(const std::string& message, int time_in_ms)
 	Host_UpdateTitle(message);
 }
 
+void SetAudioStats(const std::string& stats)
+{
+	std::lock_guard<std::mutex> lk(s_audio_stats_lock);
+	s_audio_stats = stats;
+}
+
+std::string GetAudioStats()
+{
+	std::lock_guard<std::mutex> lk(s_audio_stats_lock);
+	return s_audio_stats;
+}
+
 bool IsRunning()
 {
 	return (GetState() != CORE_UNINITIALIZED || s_hardware_initialized) && !s_is_stopping;
@@ -287,10 +312,6 @@ void Stop()  // - Hammertime!
 #if defined(__LIBUSB__) || defined(_WIN32)
 	GCAdapter::ResetRumble();
 #endif
-
-#ifdef USE_MEMORYWATCHER
-	s_memory_watcher.reset();
-#endif
 }
 
 void DeclareAsCPUThread()
@@ -365,9 +386,18 @@ static void CpuThread()
 	s_memory_watcher = std::make_unique<MemoryWatcher>();
 #endif
 
+	SamplingProfiler::RegisterCPUThread();
+
 	// Enter CPU run loop. When we leave it - we are done.
 	CPU::Run();
 
+	SamplingProfiler::UnregisterCPUThread();
+
+#ifdef USE_MEMORYWATCHER
+	// Destroyed here rather than in Stop() as the per-frame modes sample on this thread.
+	s_memory_watcher.reset();
+#endif
+
 	s_is_started = false;
 
 	if (!_CoreParameter.bCPUThread)
@@ -486,6 +516,9 @@ void EmuThread()
 
 	}
 
+	// Poll the input devices off the CPU thread while the game runs
+	g_controller_interface.SetPollingThread(core_parameter.m_InputPollingThread);
+
 	AudioCommon::InitSoundStream(s_window_handle);
 
 	// The hardware is initialized.
@@ -579,6 +612,9 @@ void EmuThread()
 
 	INFO_LOG(CONSOLE, "%s", StopMessage(true, "CPU thread stopped.").c_str());
 
+	// There is no CPU thread left to sample
+	SamplingProfiler::Stop();
+
 	if (core_parameter.bCPUThread)
 		video_backend->Video_Cleanup();
 
@@ -594,6 +630,8 @@ void EmuThread()
 	HW::Shutdown();
 	INFO_LOG(CONSOLE, "%s", StopMessage(false, "HW shutdown").c_str());
 
+	g_controller_interface.SetPollingThread(false);
+
 	if (init_controllers)
 	{
 		Wiimote::Shutdown();
@@ -803,6 +841,9 @@ void Callback_VideoCopiedToXFB(bool video_update)
 		s_drawn_frame++;
 
 	Movie::FrameUpdate();
+
+	if (s_on_frame_callback)
+		s_on_frame_callback();
 }
 
 void UpdateTitle()
@@ -873,6 +914,9 @@ void Shutdown()
 	// on MSDN.
 	if (s_emu_thread.joinable())
 		s_emu_thread.join();
+
+	// The debugger can start the profiler without a game running
+	SamplingProfiler::Stop();
 }
 
 void SetOnStoppedCallback(StoppedCallbackFunc callback)
@@ -880,6 +924,11 @@ void SetOnStoppedCallback(StoppedCallbackFunc callback)
 	s_on_stopped_callback = callback;
 }
 
+void SetOnFrameCallback(FrameCallbackFunc callback)
+{
+	s_on_frame_callback = callback;
+}
+
 void UpdateWantDeterminism(bool initial)
 {
 	// For now, this value is not itself configurable.  Instead, individual
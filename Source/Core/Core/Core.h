@@ -63,12 +63,19 @@ void Callback_WiimoteInterruptChannel(int _number, u16 _channelID, const void* _
 // This displays messages in a user-visible way.
 void DisplayMessage(const std::string& message, int time_in_ms);
 
+// Output statistics published by the audio backend for the statistics overlay.
+// Safe to call from any thread.
+void SetAudioStats(const std::string& stats);
+std::string GetAudioStats();
+
 std::string GetStateFileName();
 void SetStateFileName(const std::string& val);
 
 void SetBlockStart(u32 addr);
 
 void FrameUpdateOnCPUThread();
+// Called by VI at the end of every field.
+void FieldEndOnCPUThread();
 
 bool ShouldSkipFrame(int skipped);
 void VideoThrottle();
@@ -85,6 +92,9 @@ bool PauseAndLock(bool doLock, bool unpauseOnUnlock=true);
 // for calling back into UI code without introducing a dependency on it in core
 typedef void(*StoppedCallbackFunc)(void);
 void SetOnStoppedCallback(StoppedCallbackFunc callback);
+// Run on the GPU thread for every frame copied to the XFB, the frames counted by movies.
+typedef void(*FrameCallbackFunc)(void);
+void SetOnFrameCallback(FrameCallbackFunc callback);
 
 // Run on the GUI thread when the factors change.
 void UpdateWantDeterminism(bool initial = false);
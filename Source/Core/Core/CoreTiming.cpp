@@ -56,6 +56,8 @@ int g_slicelength;
 static int maxslicelength = MAX_SLICE_LENGTH;
 
 static s64 idledCycles;
+// Not savestated, only reported when emulation stops.
+static u64 s_idle_skips;
 static u32 fakeDecStartValue;
 static u64 fakeDecStartTicks;
 
@@ -142,6 +144,7 @@ void Init()
 	g_slicelength = maxslicelength;
 	g_globalTimer = 0;
 	idledCycles = 0;
+	s_idle_skips = 0;
 	globalTimerIsSane = true;
 
 	ev_lost = RegisterEvent("_lost_event", &EmptyTimedCallback);
@@ -149,6 +152,13 @@ void Init()
 
 void Shutdown()
 {
+	if (s_idle_skips)
+	{
+		INFO_LOG(POWERPC, "%s: skipped %" PRId64 " idle cycles (%.1f%% of %" PRIu64 ") in %" PRIu64 " idle loop exits",
+		         SConfig::GetInstance().GetUniqueID().c_str(), idledCycles,
+		         g_globalTimer ? 100.0 * idledCycles / g_globalTimer : 0.0, (u64)g_globalTimer, s_idle_skips);
+	}
+
 	std::lock_guard<std::mutex> lk(tsWriteLock);
 	MoveEvents();
 	ClearPendingEvents();
@@ -475,6 +485,7 @@ void Idle()
 	}
 
 	idledCycles += DowncountToCycles(PowerPC::ppcState.downcount);
+	s_idle_skips++;
 	PowerPC::ppcState.downcount = 0;
 }
 
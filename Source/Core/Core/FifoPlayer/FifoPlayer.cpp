@@ -21,6 +21,7 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/TextureCacheBase.h"
 
 bool IsPlayingBackFifologWithBrokenEFBCopies = false;
 
@@ -294,6 +295,7 @@ void FifoPlayer::WriteMemory(const MemoryUpdate& memUpdate)
 		mem = &Memory::m_pRAM[memUpdate.address & Memory::RAM_MASK];
 
 	memcpy(mem, memUpdate.data, memUpdate.size);
+	TextureCacheBase::InvalidateStageBindings();
 }
 
 void FifoPlayer::WriteFifo(u8* data, u32 start, u32 end)
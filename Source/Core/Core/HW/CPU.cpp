@@ -19,6 +19,8 @@ namespace
 	static Common::Event m_StepEvent;
 	static Common::Event *m_SyncEvent = nullptr;
 	static std::mutex m_csCpuOccupied;
+	static void (*s_safe_point_callback)() = nullptr;
+	static bool s_in_safe_point_callback = false;
 }
 
 namespace CPU
@@ -50,6 +52,24 @@ void Run()
 			PowerPC::RunLoop();
 			break;
 
+		case PowerPC::CPU_SAFE_POINT:
+			if (s_safe_point_callback)
+			{
+				void (*callback)() = s_safe_point_callback;
+				s_safe_point_callback = nullptr;
+				s_in_safe_point_callback = true;
+				callback();
+				s_in_safe_point_callback = false;
+			}
+			// Carry on, unless somebody paused or stopped the CPU in the meantime. They wait
+			// for the callback to be done.
+			{
+				PowerPC::CPUState expected = PowerPC::CPU_SAFE_POINT;
+				if (!PowerPC::GetStatePtr()->compare_exchange_strong(expected, PowerPC::CPU_RUNNING))
+					PowerPC::FinishStateMove();
+			}
+			break;
+
 		case PowerPC::CPU_STEPPING:
 			m_csCpuOccupied.unlock();
 
@@ -96,6 +116,14 @@ void Reset()
 {
 }
 
+void RequestSafePoint(void (*callback)())
+{
+	s_safe_point_callback = callback;
+	// Pause and Stop set the state from other threads, they must not be undone.
+	PowerPC::CPUState expected = PowerPC::CPU_RUNNING;
+	PowerPC::GetStatePtr()->compare_exchange_strong(expected, PowerPC::CPU_SAFE_POINT);
+}
+
 void StepOpcode(Common::Event* event)
 {
 	m_StepEvent.Set();
@@ -148,6 +176,13 @@ bool PauseAndLock(bool do_lock, bool unpause_on_unlock)
 {
 	static bool s_have_fake_cpu_thread;
 	bool wasUnpaused = !IsStepping();
+
+	// A safe point callback (e.g. a netplay rollback savestate) already runs outside of the
+	// run loop. Pausing would wait for the callback itself, and unpausing would undo a Pause
+	// or Stop from another thread, so the CPU state is left alone.
+	if (s_in_safe_point_callback)
+		return wasUnpaused;
+
 	if (do_lock)
 	{
 		// we can't use EnableStepping, that would causes deadlocks with both audio and video
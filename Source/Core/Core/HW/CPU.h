@@ -38,6 +38,10 @@ void Break();
 // Is stepping ?
 bool IsStepping();
 
+// Called from the CPU thread. Makes the CPU core leave its run loop at the next point where
+// a savestate could be made, and runs callback on the CPU thread there.
+void RequestSafePoint(void (*callback)());
+
 // Waits until is stepping and is ready for a command (paused and fully idle), and acquires a lock on that state.
 // or, if doLock is false, releases a lock on that state and optionally re-disables stepping.
 // calls must be balanced and non-recursive (once with doLock true, then once with doLock false).
@@ -316,7 +316,10 @@ public:
 	std::vector<GCMBlock> m_save_data;
 	std::vector<u16> m_used_blocks;
 	int UsesBlock(u16 blocknum);
+	void MarkBlockDirty(int index);
 	bool m_dirty;
+	// Which blocks of m_save_data changed since the last flush, not part of savestates
+	std::vector<bool> m_dirty_blocks;
 	std::string m_filename;
 };
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 #include <memory>
@@ -146,11 +147,16 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot, u
 	: MemoryCardBase(slot, sizeMb)
 	, m_GameId(gameId)
 	, m_LastBlock(-1)
+	, m_LastSaveIndex(-1)
+	, m_LastSaveBlock(-1)
 	, m_hdr(slot, sizeMb, ascii)
 	, m_bat1(sizeMb)
 	, m_saves(0)
 	, m_SaveDirectory(directory)
 	, m_exiting(false)
+	, m_game_bytes_written(0)
+	, m_total_game_bytes_written(0)
+	, m_total_disk_bytes_written(0)
 {
 	// Use existing header data if available
 	if (File::Exists(m_SaveDirectory + MC_HDR))
@@ -342,7 +348,7 @@ s32 GCMemcardDirectory::Write(u32 destaddress, s32 length, u8 *srcaddress)
 			m_LastBlockAddress = (u8 *)&m_bat2;
 			break;
 		default:
-			m_LastBlock = SaveAreaRW(block, true);
+			m_LastBlock = SaveAreaRW(block);
 			if (m_LastBlock == -1)
 			{
 				PanicAlertT("Report: GCIFolder Writing to unallocated block 0x%x", block);
@@ -351,7 +357,12 @@ s32 GCMemcardDirectory::Write(u32 destaddress, s32 length, u8 *srcaddress)
 		}
 	}
 
+	// Games often rewrite blocks with the data they already hold, that doesn't need a flush
+	if (block >= MC_FST_BLOCKS && memcmp(m_LastBlockAddress + offset, srcaddress, length))
+		m_saves[m_LastSaveIndex].MarkBlockDirty(m_LastSaveBlock);
+
 	memcpy(m_LastBlockAddress + offset, srcaddress, length);
+	m_game_bytes_written += length;
 
 	l.unlock();
 	if (extra)
@@ -369,6 +380,7 @@ void GCMemcardDirectory::ClearBlock(u32 address)
 		return;
 	}
 
+	std::unique_lock<std::mutex> l(m_write_mutex);
 	u32 block = address / BLOCK_SIZE;
 	INFO_LOG(EXPANSIONINTERFACE, "Clearing block %u", block);
 	switch (block)
@@ -394,9 +406,10 @@ void GCMemcardDirectory::ClearBlock(u32 address)
 		m_LastBlockAddress = (u8 *)&m_bat2;
 		break;
 	default:
-		m_LastBlock = SaveAreaRW(block, true);
+		m_LastBlock = SaveAreaRW(block);
 		if (m_LastBlock == -1)
 			return;
+		m_saves[m_LastSaveIndex].MarkBlockDirty(m_LastSaveBlock);
 	}
 	((GCMBlock *)m_LastBlockAddress)->Erase();
 }
@@ -443,6 +456,7 @@ inline void GCMemcardDirectory::SyncSaves()
 					INFO_LOG(EXPANSIONINTERFACE, "Save moved from 0x%x to 0x%x", old_start, new_start);
 					m_saves[i].m_used_blocks.clear();
 					m_saves[i].m_save_data.clear();
+					m_saves[i].m_dirty_blocks.clear();
 				}
 				if (m_saves[i].m_used_blocks.size() == 0)
 				{
@@ -456,12 +470,13 @@ inline void GCMemcardDirectory::SyncSaves()
 			*(u32 *)&(m_saves[i].m_gci_header.Gamecode) = 0xFFFFFFFF;
 			m_saves[i].m_save_data.clear();
 			m_saves[i].m_used_blocks.clear();
+			m_saves[i].m_dirty_blocks.clear();
 			m_saves[i].m_dirty = true;
 
 		}
 	}
 }
-inline s32 GCMemcardDirectory::SaveAreaRW(u32 block, bool writing)
+inline s32 GCMemcardDirectory::SaveAreaRW(u32 block)
 {
 	for (u16 i = 0; i < m_saves.size(); ++i)
 	{
@@ -485,13 +500,10 @@ inline s32 GCMemcardDirectory::SaveAreaRW(u32 block, bool writing)
 					}
 				}
 
-				if (writing)
-				{
-					m_saves[i].m_dirty = true;
-				}
-
 				m_LastBlock = block;
 				m_LastBlockAddress = m_saves[i].m_save_data[idx].block;
+				m_LastSaveIndex = i;
+				m_LastSaveBlock = idx;
 				return m_LastBlock;
 			}
 		}
@@ -551,11 +563,40 @@ bool GCMemcardDirectory::SetUsedBlocks(int saveIndex)
 	return true;
 }
 
+// Replaces the file through a temporary one, so that it holds either the old or the new save
+static bool WriteGCIFile(const std::string& filename, const DEntry& header, const std::vector<GCMBlock>& data)
+{
+	std::string temp_filename = filename + ".tmp";
+	{
+		File::IOFile GCI(temp_filename, "wb");
+		if (!GCI)
+			return false;
+		GCI.WriteBytes(&header, DENTRY_SIZE);
+		GCI.WriteBytes(data.data(), BLOCK_SIZE * data.size());
+		if (!GCI.IsGood())
+		{
+			GCI.Close();
+			File::Delete(temp_filename);
+			return false;
+		}
+	}
+	return File::RenameSync(temp_filename, filename);
+}
+
 void GCMemcardDirectory::FlushToFile()
 {
+	// Copies of the saves to write, so that the files are written without holding m_write_mutex
+	struct PendingWrite
+	{
+		std::string filename;
+		DEntry header;
+		std::vector<GCMBlock> data;
+	};
+	std::vector<PendingWrite> pending;
+	u32 dirty_blocks = 0;
+	u64 game_bytes;
+
 	std::unique_lock<std::mutex> l(m_write_mutex);
-	int errors = 0;
-	DEntry invalid;
 	for (u16 i = 0; i < m_saves.size(); ++i)
 	{
 		if (m_saves[i].m_dirty)
@@ -585,26 +626,9 @@ void GCMemcardDirectory::FlushToFile()
 						PanicAlertT("Failed to find new filename.\n%s\n will be overwritten", defaultSaveName.c_str());
 					m_saves[i].m_filename = defaultSaveName;
 				}
-				File::IOFile GCI(m_saves[i].m_filename, "wb");
-				if (GCI)
-				{
-					GCI.WriteBytes(&m_saves[i].m_gci_header, DENTRY_SIZE);
-					GCI.WriteBytes(m_saves[i].m_save_data.data(), BLOCK_SIZE * m_saves[i].m_save_data.size());
-
-					if (GCI.IsGood())
-					{
-						Core::DisplayMessage(
-							StringFromFormat("Wrote save contents to %s", m_saves[i].m_filename.c_str()), 4000);
-					}
-					else
-					{
-						++errors;
-						Core::DisplayMessage(
-							StringFromFormat("Failed to write save contents to %s", m_saves[i].m_filename.c_str()),
-							4000);
-						ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", m_saves[i].m_filename.c_str());
-					}
-				}
+				dirty_blocks += (u32)std::count(m_saves[i].m_dirty_blocks.begin(), m_saves[i].m_dirty_blocks.end(), true);
+				m_saves[i].m_dirty_blocks.clear();
+				pending.push_back({m_saves[i].m_filename, m_saves[i].m_gci_header, m_saves[i].m_save_data});
 			}
 			else if (m_saves[i].m_filename.length() != 0)
 			{
@@ -617,6 +641,7 @@ void GCMemcardDirectory::FlushToFile()
 				m_saves[i].m_filename.clear();
 				m_saves[i].m_save_data.clear();
 				m_saves[i].m_used_blocks.clear();
+				m_saves[i].m_dirty_blocks.clear();
 			}
 		}
 
@@ -628,8 +653,41 @@ void GCMemcardDirectory::FlushToFile()
 		{
 			INFO_LOG(EXPANSIONINTERFACE, "Flushing savedata to disk for %s", m_saves[i].m_filename.c_str());
 			m_saves[i].m_save_data.clear();
+			m_LastBlock = -1;
 		}
 	}
+	game_bytes = m_game_bytes_written;
+	m_game_bytes_written = 0;
+	l.unlock();
+
+	int errors = 0;
+	u64 disk_bytes = 0;
+	for (const PendingWrite& save : pending)
+	{
+		if (WriteGCIFile(save.filename, save.header, save.data))
+		{
+			disk_bytes += DENTRY_SIZE + BLOCK_SIZE * save.data.size();
+			Core::DisplayMessage(StringFromFormat("Wrote save contents to %s", save.filename.c_str()), 4000);
+		}
+		else
+		{
+			++errors;
+			Core::DisplayMessage(StringFromFormat("Failed to write save contents to %s", save.filename.c_str()), 4000);
+			ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", save.filename.c_str());
+		}
+	}
+
+	if (!pending.empty())
+	{
+		l.lock();
+		m_total_game_bytes_written += game_bytes;
+		m_total_disk_bytes_written += disk_bytes;
+		INFO_LOG(EXPANSIONINTERFACE, "Flushed %u saves with %u changed blocks: wrote %" PRIu64 " bytes for %" PRIu64
+		         " bytes written by the game, %" PRIu64 "/%" PRIu64 " bytes in total",
+		         (u32)pending.size(), dirty_blocks, disk_bytes, game_bytes, m_total_disk_bytes_written,
+		         m_total_game_bytes_written);
+		l.unlock();
+	}
 #if _WRITE_MC_HEADER
 	u8 mc[BLOCK_SIZE * MC_FST_BLOCKS];
 	Read(0, BLOCK_SIZE * MC_FST_BLOCKS, mc);
@@ -693,6 +751,14 @@ int GCIFile::UsesBlock(u16 blocknum)
 	return -1;
 }
 
+void GCIFile::MarkBlockDirty(int index)
+{
+	if (m_dirty_blocks.size() < m_save_data.size())
+		m_dirty_blocks.resize(m_save_data.size());
+	m_dirty_blocks[index] = true;
+	m_dirty = true;
+}
+
 void GCIFile::DoState(PointerWrap &p)
 {
 	p.DoPOD<DEntry>(m_gci_header);
@@ -706,6 +772,8 @@ void GCIFile::DoState(PointerWrap &p)
 		p.DoPOD<GCMBlock>(*itr);
 	}
 	p.Do(m_used_blocks);
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		m_dirty_blocks.clear();
 }
 
 void MigrateFromMemcardFile(const std::string& strDirectoryName, int card_index)
@@ -36,7 +36,7 @@ public:
 
 private:
 	int LoadGCI(const std::string& fileName, DiscIO::IVolume::ECountry card_region, bool currentGameOnly);
-	inline s32 SaveAreaRW(u32 block, bool writing = false);
+	inline s32 SaveAreaRW(u32 block);
 	// s32 DirectoryRead(u32 offset, u32 length, u8* destaddress);
 	s32 DirectoryWrite(u32 destaddress, u32 length, u8 *srcaddress);
 	inline void SyncSaves();
@@ -45,6 +45,9 @@ private:
 	u32 m_GameId;
 	s32 m_LastBlock;
 	u8 *m_LastBlockAddress;
+	// Save and index into its m_save_data of m_LastBlock, if it is in the save area
+	s32 m_LastSaveIndex;
+	s32 m_LastSaveBlock;
 
 	Header m_hdr;
 	Directory m_dir1, m_dir2;
@@ -58,4 +61,9 @@ private:
 	std::mutex m_write_mutex;
 	std::atomic<bool> m_exiting;
 	std::thread m_flush_thread;
+
+	// Write amplification statistics, protected by m_write_mutex
+	u64 m_game_bytes_written;
+	u64 m_total_game_bytes_written;
+	u64 m_total_disk_bytes_written;
 };
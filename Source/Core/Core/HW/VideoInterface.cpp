@@ -703,6 +703,7 @@ static void EndField()
 {
 	g_video_backend->Video_EndField();
 	Core::VideoThrottle();
+	Core::FieldEndOnCPUThread();
 }
 
 // Purpose: Send VI interrupt when triggered
@@ -3,11 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #ifndef _WIN32
 #include <unistd.h>
 #endif
 
 #include "Common/FileUtil.h"
+#include "Common/Thread.h"
 #include "Core/Core.h"
 #include "Core/IPC_HLE/WII_IPC_HLE.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device.h"
@@ -547,6 +549,7 @@ void WiiSocket::DoSock(u32 _CommandAddress, NET_IOCTL type)
 	sockop so = {_CommandAddress, false};
 	so.net_type = type;
 	pending_sockops.push_back(so);
+	has_new_ops = true;
 }
 
 void WiiSocket::DoSock(u32 _CommandAddress, SSL_IOCTL type)
@@ -554,6 +557,12 @@ void WiiSocket::DoSock(u32 _CommandAddress, SSL_IOCTL type)
 	sockop so = {_CommandAddress, true};
 	so.ssl_type = type;
 	pending_sockops.push_back(so);
+	has_new_ops = true;
+}
+
+WiiSockMan::~WiiSockMan()
+{
+	StopIOThread();
 }
 
 void WiiSockMan::AddSocket(s32 fd)
@@ -562,7 +571,105 @@ void WiiSockMan::AddSocket(s32 fd)
 	{
 		WiiSocket& sock = WiiSockets[fd];
 		sock.SetFd(fd);
+		WatchSocket(fd);
+	}
+}
+
+void WiiSockMan::StartIOThread()
+{
+#ifdef USE_EPOLL_REACTOR
+	if (m_io_running.IsSet())
+		return;
+
+	m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_epoll_fd < 0 || m_wake_fd < 0)
+	{
+		ERROR_LOG(WII_IPC_NET, "Failed to create socket reactor: %s", DecodeError(errno));
+		if (m_epoll_fd >= 0)
+			close(m_epoll_fd);
+		if (m_wake_fd >= 0)
+			close(m_wake_fd);
+		m_epoll_fd = m_wake_fd = -1;
+		return;
+	}
+
+	epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.fd = m_wake_fd;
+	epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &ev);
+
+	m_io_running.Set();
+	m_io_thread = std::thread(&WiiSockMan::IOThread, this);
+#endif
+}
+
+void WiiSockMan::StopIOThread()
+{
+#ifdef USE_EPOLL_REACTOR
+	if (!m_io_running.TestAndClear())
+		return;
+
+	u64 wake = 1;
+	if (write(m_wake_fd, &wake, sizeof(wake)) < 0)
+		ERROR_LOG(WII_IPC_NET, "Failed to wake socket reactor: %s", DecodeError(errno));
+	m_io_thread.join();
+
+	close(m_epoll_fd);
+	close(m_wake_fd);
+	m_epoll_fd = m_wake_fd = -1;
+
+	std::lock_guard<std::mutex> lk(m_ready_lock);
+	m_ready_fds.clear();
+#endif
+}
+
+void WiiSockMan::WatchSocket(s32 fd)
+{
+#ifdef USE_EPOLL_REACTOR
+	StartIOThread();
+	if (m_epoll_fd < 0)
+		return;
+
+	// Edge triggered: we only need to know that the state changed since the
+	// last attempt. Closing the fd removes it from the epoll set automatically.
+	epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLRDHUP | EPOLLET;
+	ev.data.fd = fd;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0 &&
+	    (errno != EEXIST || epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0))
+	{
+		ERROR_LOG(WII_IPC_NET, "Failed to watch socket %08x: %s", fd, DecodeError(errno));
+	}
+#endif
+}
+
+void WiiSockMan::IOThread()
+{
+#ifdef USE_EPOLL_REACTOR
+	Common::SetCurrentThreadName("Wii socket reactor");
+
+	std::array<epoll_event, 64> events;
+	while (m_io_running.IsSet())
+	{
+		int count = epoll_wait(m_epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			ERROR_LOG(WII_IPC_NET, "epoll_wait failed: %s", DecodeError(errno));
+			break;
+		}
+
+		std::lock_guard<std::mutex> lk(m_ready_lock);
+		for (int i = 0; i < count; ++i)
+		{
+			if (events[i].data.fd == m_wake_fd)
+				continue;
+			m_ready_fds[events[i].data.fd] |= events[i].events;
+		}
 	}
+#endif
 }
 
 s32 WiiSockMan::NewSocket(s32 af, s32 type, s32 protocol)
@@ -583,6 +690,50 @@ s32 WiiSockMan::DeleteSocket(s32 s)
 
 void WiiSockMan::Update()
 {
+#ifdef USE_EPOLL_REACTOR
+	if (m_epoll_fd >= 0)
+	{
+		std::unordered_map<s32, u32> ready;
+		{
+			std::lock_guard<std::mutex> lk(m_ready_lock);
+			ready.swap(m_ready_fds);
+		}
+
+		// Some operations can stay pending for reasons epoll does not report
+		// (e.g. SSL state), so retry everything now and then. When determinism
+		// is wanted, never let host-side readiness timing decide what runs.
+		bool retry_all = m_want_determinism || (++m_update_count % 64) == 0;
+
+		auto socket_iter = WiiSockets.begin();
+		while (socket_iter != WiiSockets.end())
+		{
+			WiiSocket& sock = socket_iter->second;
+			if (!sock.IsValid())
+			{
+				socket_iter = WiiSockets.erase(socket_iter);
+				continue;
+			}
+
+			if (!sock.pending_sockops.empty())
+			{
+				auto ready_entry = ready.find(sock.fd);
+				if (sock.has_new_ops || retry_all || ready_entry != ready.end())
+				{
+					u32 events = ready_entry != ready.end() ? ready_entry->second : 0;
+					sock.has_new_ops = false;
+					sock.Update(
+						(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0,
+						(events & EPOLLOUT) != 0,
+						(events & (EPOLLPRI | EPOLLERR)) != 0
+					);
+				}
+			}
+			++socket_iter;
+		}
+		return;
+	}
+#endif
+
 	s32 nfds = 0;
 	fd_set read_fds, write_fds, except_fds;
 	struct timeval t = {0,0};
@@ -667,6 +818,8 @@ void WiiSockMan::Convert(sockaddr_in const & from, WiiSockAddrIn& to, s32 addrle
 
 void WiiSockMan::UpdateWantDeterminism(bool want)
 {
+	m_want_determinism = want;
+
 	// If we switched into movie recording, kill existing sockets.
 	if (want)
 		Clean();
@@ -31,6 +31,11 @@ typedef pollfd pollfd_t;
 #include <errno.h>
 #include <poll.h>
 #include <string.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define USE_EPOLL_REACTOR 1
+#endif
 
 typedef struct pollfd pollfd_t;
 #else
@@ -44,10 +49,13 @@ typedef struct pollfd pollfd_t;
 #include <algorithm>
 #include <cstdio>
 #include <list>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "Common/CommonTypes.h"
+#include "Common/Flag.h"
 #include "Common/NonCopyable.h"
 #include "Core/IPC_HLE/WII_IPC_HLE.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_net.h"
@@ -180,6 +188,9 @@ class WiiSocket
 private:
 	s32 fd;
 	bool nonBlock;
+	// Set when a command was queued since the last Update, so it gets tried
+	// once even if the reactor has not reported the socket as ready.
+	bool has_new_ops;
 	std::list<sockop> pending_sockops;
 
 	friend class WiiSockMan;
@@ -192,7 +203,7 @@ private:
 	void Update(bool read, bool write, bool except);
 	bool IsValid() const { return fd >= 0; }
 public:
-	WiiSocket() : fd(-1), nonBlock(false) {}
+	WiiSocket() : fd(-1), nonBlock(false), has_new_ops(false) {}
 	~WiiSocket();
 	void operator=(WiiSocket const&) = delete;
 
@@ -223,6 +234,7 @@ public:
 	void Clean()
 	{
 		WiiSockets.clear();
+		StopIOThread();
 	}
 
 	template <typename T>
@@ -247,7 +259,26 @@ public:
 
 private:
 	WiiSockMan() = default;
+	~WiiSockMan();
+
+	void StartIOThread();
+	void StopIOThread();
+	void WatchSocket(s32 fd);
+	void IOThread();
 
 	std::unordered_map<s32, WiiSocket> WiiSockets;
 	s32 errno_last;
+	bool m_want_determinism = false;
+
+	// Readiness reactor: a dedicated thread waits on all sockets with epoll and
+	// records which ones became ready, so Update only has to retry the pending
+	// commands of those sockets instead of rebuilding fd_sets and polling.
+	// Commands themselves are still executed (and replied to) on the CPU thread.
+	std::thread m_io_thread;
+	Common::Flag m_io_running;
+	int m_epoll_fd = -1;
+	int m_wake_fd = -1;
+	std::mutex m_ready_lock;
+	std::unordered_map<s32, u32> m_ready_fds;
+	u32 m_update_count = 0;
 };
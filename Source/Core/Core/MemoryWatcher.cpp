@@ -2,37 +2,74 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
+#include <new>
 #include <sstream>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 
+#include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
 #include "Common/Thread.h"
+#include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
 #include "Core/MemoryWatcher.h"
 #include "Core/HW/Memmap.h"
 
 // We don't want to kill the cpu, so sleep for this long after polling.
 static const int SLEEP_DURATION = 2; // ms
 
+// Keeps the batched datagrams well below the default socket buffer size.
+static const size_t MAX_BATCH_ENTRIES = 8192;
+
+// The slots of the shared memory file start at this offset.
+static const size_t SHARED_HEADER_SIZE = 64;
+static_assert(sizeof(MemoryWatcher::SharedHeader) <= SHARED_HEADER_SIZE, "SharedHeader too large");
+
 MemoryWatcher::MemoryWatcher()
 {
+	const std::string& mode = SConfig::GetInstance().m_strMemoryWatcherMode;
+	if (mode == "frame")
+		m_mode = Mode::Frame;
+	else if (mode == "shm")
+		m_mode = Mode::SharedMemory;
+
 	if (!LoadAddresses(File::GetUserPath(F_MEMORYWATCHERLOCATIONS_IDX)))
 		return;
-	if (!OpenSocket(File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX)))
+
+	if (m_mode == Mode::SharedMemory)
+	{
+		if (!OpenSharedMemory(File::GetUserPath(D_MEMORYWATCHER_IDX) + MEMORYWATCHER_SHM))
+			return;
+	}
+	else if (!OpenSocket(File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX)))
+	{
 		return;
+	}
+
 	m_running = true;
-	m_watcher_thread = std::thread(&MemoryWatcher::WatcherThread, this);
+	if (m_mode == Mode::Thread)
+		m_watcher_thread = std::thread(&MemoryWatcher::WatcherThread, this);
 }
 
 MemoryWatcher::~MemoryWatcher()
 {
-	if (!m_running)
-		return;
+	if (m_running)
+	{
+		m_running = false;
+		if (m_watcher_thread.joinable())
+			m_watcher_thread.join();
+	}
 
-	m_running = false;
-	m_watcher_thread.join();
-	close(m_fd);
+	if (m_fd >= 0)
+		close(m_fd);
+	if (m_shared)
+		munmap(m_shared, m_shared_size);
 }
 
 bool MemoryWatcher::LoadAddresses(const std::string& path)
@@ -42,22 +79,27 @@ bool MemoryWatcher::LoadAddresses(const std::string& path)
 		return false;
 
 	std::string line;
-	while (std::getline(locations, line))
-		ParseLine(line);
+	for (u32 id = 0; std::getline(locations, line); id++)
+		ParseLine(id, line);
 
-	return m_values.size() > 0;
+	return m_watches.size() > 0;
 }
 
-void MemoryWatcher::ParseLine(const std::string& line)
+void MemoryWatcher::ParseLine(u32 id, const std::string& line)
 {
-	m_values[line] = 0;
-	m_addresses[line] = std::vector<u32>();
+	Watch watch;
+	watch.id = id;
+	watch.line = line;
+	watch.value = 0;
 
 	std::stringstream offsets(line);
 	offsets >> std::hex;
 	u32 offset;
 	while (offsets >> offset)
-		m_addresses[line].push_back(offset);
+		watch.offsets.push_back(offset);
+
+	if (!watch.offsets.empty())
+		m_watches.push_back(std::move(watch));
 }
 
 bool MemoryWatcher::OpenSocket(const std::string& path)
@@ -70,18 +112,54 @@ bool MemoryWatcher::OpenSocket(const std::string& path)
 	return m_fd >= 0;
 }
 
-u32 MemoryWatcher::ChasePointer(const std::string& line)
+bool MemoryWatcher::OpenSharedMemory(const std::string& path)
+{
+	// The ids index the values of a slot, so it has room for the highest one.
+	u32 count = 0;
+	for (const Watch& watch : m_watches)
+		count = std::max(count, watch.id + 1);
+	const u32 slot_size = (count + 1) * sizeof(u32);
+	m_shared_size = SHARED_HEADER_SIZE + SHARED_SLOTS * slot_size;
+
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		ERROR_LOG(COMMON, "MemoryWatcher: failed to create %s", path.c_str());
+		return false;
+	}
+	if (ftruncate(fd, m_shared_size) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	void* ptr = mmap(nullptr, m_shared_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (ptr == MAP_FAILED)
+		return false;
+
+	// The file was truncated, everything is zero, so no slot holds a frame yet.
+	m_shared = static_cast<u8*>(ptr);
+	SharedHeader* header = new (m_shared) SharedHeader;
+	header->magic = SHARED_MAGIC;
+	header->version = SHARED_VERSION;
+	header->count = count;
+	header->slot_size = slot_size;
+	header->frame.store(0, std::memory_order_release);
+	return true;
+}
+
+u32 MemoryWatcher::ChasePointer(const Watch& watch)
 {
 	u32 value = 0;
-	for (u32 offset : m_addresses[line])
+	for (u32 offset : watch.offsets)
 		value = Memory::Read_U32(value + offset);
 	return value;
 }
 
-std::string MemoryWatcher::ComposeMessage(const std::string& line, u32 value)
+std::string MemoryWatcher::ComposeMessage(const Watch& watch)
 {
 	std::stringstream message_stream;
-	message_stream << line << '\n' << std::hex << value;
+	message_stream << watch.line << '\n' << std::hex << watch.value;
 	return message_stream.str();
 }
 
@@ -89,17 +167,14 @@ void MemoryWatcher::WatcherThread()
 {
 	while (m_running)
 	{
-		for (auto& entry : m_values)
+		for (Watch& watch : m_watches)
 		{
-			std::string address = entry.first;
-			u32& current_value = entry.second;
-
-			u32 new_value = ChasePointer(address);
-			if (new_value != current_value)
+			u32 new_value = ChasePointer(watch);
+			if (new_value != watch.value)
 			{
 				// Update the value
-				current_value = new_value;
-				std::string message = ComposeMessage(address, new_value);
+				watch.value = new_value;
+				std::string message = ComposeMessage(watch);
 				sendto(
 					m_fd,
 					message.c_str(),
@@ -112,3 +187,73 @@ void MemoryWatcher::WatcherThread()
 		Common::SleepCurrentThread(SLEEP_DURATION);
 	}
 }
+
+void MemoryWatcher::Step()
+{
+	if (!m_running || m_mode == Mode::Thread)
+		return;
+
+	// Frame 0 marks empty slots in the shared memory.
+	if (++m_frame == 0)
+		m_frame = 1;
+
+	if (m_mode == Mode::Frame)
+		SendBatch();
+	else
+		WriteSharedMemory();
+}
+
+void MemoryWatcher::SendBatch()
+{
+	// The first batch holds every value, later ones only what changed.
+	const bool send_all = m_frame == 1;
+	m_batch.clear();
+	for (Watch& watch : m_watches)
+	{
+		u32 new_value = ChasePointer(watch);
+		if (new_value != watch.value || send_all)
+		{
+			watch.value = new_value;
+			m_batch.push_back({watch.id, new_value});
+		}
+	}
+
+	for (size_t start = 0; start < m_batch.size(); start += MAX_BATCH_ENTRIES)
+	{
+		BatchHeader header;
+		header.magic = BATCH_MAGIC;
+		header.frame = m_frame;
+		header.count = static_cast<u32>(std::min(m_batch.size() - start, MAX_BATCH_ENTRIES));
+
+		iovec iov[2];
+		iov[0].iov_base = &header;
+		iov[0].iov_len = sizeof(header);
+		iov[1].iov_base = &m_batch[start];
+		iov[1].iov_len = header.count * sizeof(BatchEntry);
+
+		msghdr msg = {};
+		msg.msg_name = &m_addr;
+		msg.msg_namelen = sizeof(m_addr);
+		msg.msg_iov = iov;
+		msg.msg_iovlen = 2;
+		sendmsg(m_fd, &msg, MSG_DONTWAIT);
+	}
+}
+
+void MemoryWatcher::WriteSharedMemory()
+{
+	SharedHeader* header = reinterpret_cast<SharedHeader*>(m_shared);
+	u8* slot = m_shared + SHARED_HEADER_SIZE + (m_frame % SHARED_SLOTS) * header->slot_size;
+	std::atomic<u32>* slot_frame = reinterpret_cast<std::atomic<u32>*>(slot);
+	u32* values = reinterpret_cast<u32*>(slot) + 1;
+
+	slot_frame->store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (Watch& watch : m_watches)
+	{
+		watch.value = ChasePointer(watch);
+		values[watch.id] = watch.value;
+	}
+	slot_frame->store(m_frame, std::memory_order_release);
+	header->frame.store(m_frame, std::memory_order_release);
+}
@@ -5,44 +5,125 @@
 #pragma once
 
 #include <atomic>
-#include <map>
+#include <string>
 #include <thread>
 #include <vector>
 #include <sys/socket.h>
 #include <sys/un.h>
 
+#include "Common/CommonTypes.h"
+
 // MemoryWatcher reads a file containing in-game memory addresses and outputs
 // changes to those memory addresses to a unix domain socket as the game runs.
 //
 // The input file is a newline-separated list of hex memory addresses, without
 // the "0x". To follow pointers, separate addresses with a space. For example,
 // "ABCD EF" will watch the address at (*0xABCD) + 0xEF.
-// The output to the socket is two lines. The first is the address from the
-// input file, and the second is the new value in hex.
+//
+// The output depends on the MemoryWatcherMode setting:
+//
+// "thread": a separate thread polls the addresses every few milliseconds. Each
+// change is sent as its own datagram of two lines. The first is the address from
+// the input file, and the second is the new value in hex.
+//
+// "frame": the addresses are sampled on the CPU thread at the end of every VI
+// field, so all values belong to the same emulated frame. The changes of a field
+// are sent in one binary datagram: a BatchHeader followed by BatchEntry records.
+// Entries are identified by the zero-based line number in the input file. The
+// first batch holds every value.
+//
+// "shm": sampled like "frame", but every value is written to a ring of slots in
+// the file MemoryWatcher.shm next to the socket, which readers can mmap. See
+// SharedHeader for the layout.
+//
+// All binary data is in host byte order.
 class MemoryWatcher final
 {
 public:
+	enum : u32
+	{
+		BATCH_MAGIC = 0x424d5744,  // "DWMB"
+		SHARED_MAGIC = 0x534d5744,  // "DWMS"
+		SHARED_VERSION = 1,
+		SHARED_SLOTS = 16,
+	};
+
+	struct BatchHeader
+	{
+		u32 magic;
+		u32 frame;
+		u32 count;
+	};
+
+	struct BatchEntry
+	{
+		u32 id;
+		u32 value;
+	};
+
+	// At the start of the file, padded to 64 bytes, followed by SHARED_SLOTS slots of
+	// slot_size bytes. A slot is a u32 frame number and then count u32 values, indexed by
+	// id. The writer sets the frame of a slot to 0 before it updates the values, then to the
+	// frame number, then publishes the frame number in the header; frame N is written to
+	// slot N % SHARED_SLOTS. A reader copies the slot of the published frame and retries
+	// if the slot's frame number changed in the meantime.
+	struct SharedHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 count;
+		u32 slot_size;
+		std::atomic<u32> frame;
+	};
+
 	MemoryWatcher();
 	~MemoryWatcher();
 
+	// Samples the addresses in the "frame" and "shm" modes. Called on the CPU thread.
+	void Step();
+
 private:
+	enum class Mode
+	{
+		Thread,
+		Frame,
+		SharedMemory,
+	};
+
+	struct Watch
+	{
+		u32 id;
+		std::string line;
+		std::vector<u32> offsets;
+		u32 value;
+	};
+
 	bool LoadAddresses(const std::string& path);
 	bool OpenSocket(const std::string& path);
+	bool OpenSharedMemory(const std::string& path);
 
-	void ParseLine(const std::string& line);
-	u32 ChasePointer(const std::string& line);
-	std::string ComposeMessage(const std::string& line, u32 value);
+	void ParseLine(u32 id, const std::string& line);
+	static u32 ChasePointer(const Watch& watch);
+	static std::string ComposeMessage(const Watch& watch);
 
 	void WatcherThread();
+	void SendBatch();
+	void WriteSharedMemory();
+
+	Mode m_mode = Mode::Thread;
 
 	std::thread m_watcher_thread;
 	std::atomic_bool m_running{false};
 
-	int m_fd;
+	int m_fd = -1;
 	sockaddr_un m_addr;
 
-	// Address as stored in the file -> list of offsets to follow
-	std::map<std::string, std::vector<u32>> m_addresses;
-	// Address as stored in the file -> current value
-	std::map<std::string, u32> m_values;
+	std::vector<Watch> m_watches;
+
+	// Only used in the per-frame modes.
+	u32 m_frame = 0;
+	std::vector<BatchEntry> m_batch;
+
+	u8* m_shared = nullptr;
+	size_t m_shared_size = 0;
 };
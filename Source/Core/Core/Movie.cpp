@@ -2,7 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
+#include <condition_variable>
+#include <fstream>
 #include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include <mbedtls/config.h>
 #include <mbedtls/md.h>
 
@@ -12,6 +20,7 @@
 #include "Common/Hash.h"
 #include "Common/NandPaths.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Common/Timer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -1372,6 +1381,185 @@ void GetSettings()
 
 static const mbedtls_md_info_t* s_md5_info = mbedtls_md_info_from_type(MBEDTLS_MD_MD5);
 
+// Digests of game files are kept in the cache directory, keyed by path, size and modification
+// time, so that playing or recording another movie of the same game doesn't hash it again.
+// Each line is "md5 size mtime path", the most recently added last.
+static const size_t MD5_CACHE_MAX_ENTRIES = 256;
+static std::mutex s_md5_cache_lock;
+
+struct MD5CacheEntry
+{
+	std::string md5;
+	u64 size;
+	u64 mtime;
+	std::string path;
+};
+
+static std::vector<MD5CacheEntry> LoadMD5Cache()
+{
+	std::vector<MD5CacheEntry> entries;
+	std::ifstream cache;
+	OpenFStream(cache, File::GetUserPath(D_CACHE_IDX) + MOVIE_MD5_CACHE, std::ios_base::in);
+
+	std::string line;
+	while (std::getline(cache, line))
+	{
+		std::istringstream line_stream(line);
+		MD5CacheEntry entry;
+		if (line_stream >> entry.md5 >> entry.size >> entry.mtime && line_stream.get() == ' ' &&
+		    std::getline(line_stream, entry.path) && entry.md5.size() == 32)
+			entries.push_back(std::move(entry));
+	}
+	return entries;
+}
+
+static bool GetCachedMD5(const std::string& path, u64 size, u64 mtime, u8* md5)
+{
+	std::lock_guard<std::mutex> lk(s_md5_cache_lock);
+	for (const MD5CacheEntry& entry : LoadMD5Cache())
+	{
+		if (entry.path != path || entry.size != size || entry.mtime != mtime)
+			continue;
+		for (int i = 0; i < 16; i++)
+			md5[i] = (u8)strtoul(entry.md5.substr(i * 2, 2).c_str(), nullptr, 16);
+		return true;
+	}
+	return false;
+}
+
+static void AddCachedMD5(const std::string& path, u64 size, u64 mtime, const u8* md5)
+{
+	std::lock_guard<std::mutex> lk(s_md5_cache_lock);
+	std::vector<MD5CacheEntry> entries = LoadMD5Cache();
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const MD5CacheEntry& entry) {
+		return entry.path == path;
+	}), entries.end());
+	if (entries.size() >= MD5_CACHE_MAX_ENTRIES)
+		entries.erase(entries.begin(), entries.end() - (MD5_CACHE_MAX_ENTRIES - 1));
+	std::string md5_str;
+	for (int i = 0; i < 16; i++)
+		md5_str += StringFromFormat("%02x", md5[i]);
+	entries.push_back({md5_str, size, mtime, path});
+
+	// Replaced in one go, other instances may be reading it. They may also be writing it,
+	// so every writer needs a temporary file of its own.
+	const std::string cache_path = File::GetUserPath(D_CACHE_IDX) + MOVIE_MD5_CACHE;
+	const std::string temp_path = StringFromFormat("%s.%08x.tmp", cache_path.c_str(), std::random_device()());
+	File::CreateFullPath(cache_path);
+	{
+		File::IOFile file(temp_path, "w");
+		for (const MD5CacheEntry& entry : entries)
+		{
+			std::string line = StringFromFormat("%s %" PRIu64 " %" PRIu64 " %s\n", entry.md5.c_str(),
+			                                    entry.size, entry.mtime, entry.path.c_str());
+			if (!file.WriteBytes(line.data(), line.size()))
+			{
+				file.Close();
+				File::Delete(temp_path);
+				return;
+			}
+		}
+	}
+	File::RenameSync(temp_path, cache_path);
+}
+
+// The file is read on a second thread in large blocks while this one hashes the previous
+// ones, so hashing doesn't wait for the disk. The digest is of the file as it is stored,
+// compressed images aren't decompressed.
+static bool HashFile(const std::string& path, u8* md5)
+{
+	File::IOFile file(path, "rb");
+	if (!file)
+		return false;
+
+	const size_t BLOCK_SIZE = 4 * 1024 * 1024;
+	const u64 NUM_BLOCKS = 4;
+	std::vector<u8> blocks[NUM_BLOCKS];
+	size_t block_sizes[NUM_BLOCKS];
+	u64 blocks_read = 0;
+	u64 blocks_hashed = 0;
+	bool done = false;
+	bool failed = false;
+	std::mutex lock;
+	std::condition_variable block_read;
+	std::condition_variable block_hashed;
+
+	std::thread reader([&] {
+		Common::SetCurrentThreadName("Movie MD5 reader");
+
+		u64 remaining = file.GetSize();
+		while (remaining > 0)
+		{
+			{
+				std::unique_lock<std::mutex> lk(lock);
+				block_hashed.wait(lk, [&] { return blocks_read - blocks_hashed < NUM_BLOCKS; });
+			}
+
+			// Only the hashing thread uses the other blocks in the meantime
+			std::vector<u8>& block = blocks[blocks_read % NUM_BLOCKS];
+			size_t size = (size_t)std::min<u64>(remaining, BLOCK_SIZE);
+			block.resize(size);
+			bool ok = file.ReadBytes(block.data(), size);
+
+			std::lock_guard<std::mutex> lk(lock);
+			if (!ok)
+			{
+				failed = true;
+				break;
+			}
+			block_sizes[blocks_read % NUM_BLOCKS] = size;
+			blocks_read++;
+			remaining -= size;
+			block_read.notify_one();
+		}
+
+		std::lock_guard<std::mutex> lk(lock);
+		done = true;
+		block_read.notify_one();
+	});
+
+	mbedtls_md_context_t ctx;
+	mbedtls_md_init(&ctx);
+	mbedtls_md_setup(&ctx, s_md5_info, 0);
+	mbedtls_md_starts(&ctx);
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lk(lock);
+			block_read.wait(lk, [&] { return blocks_hashed < blocks_read || done; });
+			if (blocks_hashed == blocks_read)
+				break;
+		}
+
+		u64 index = blocks_hashed % NUM_BLOCKS;
+		mbedtls_md_update(&ctx, blocks[index].data(), block_sizes[index]);
+
+		std::lock_guard<std::mutex> lk(lock);
+		blocks_hashed++;
+		block_hashed.notify_one();
+	}
+	mbedtls_md_finish(&ctx, md5);
+	mbedtls_md_free(&ctx);
+
+	reader.join();
+	return !failed;
+}
+
+// Gets the MD5 of the game file, from the cache if it hasn't changed since it was hashed
+static bool GetGameMD5(u8* md5)
+{
+	const std::string& path = SConfig::GetInstance().m_strFilename;
+	u64 size = File::GetSize(path);
+	u64 mtime = File::GetModificationTime(path);
+	if (GetCachedMD5(path, size, mtime, md5))
+		return true;
+
+	if (!HashFile(path, md5))
+		return false;
+	AddCachedMD5(path, size, mtime, md5);
+	return true;
+}
+
 void CheckMD5()
 {
 	for (int i = 0, n = 0; i < 16; ++i)
@@ -1385,9 +1573,7 @@ void CheckMD5()
 	Core::DisplayMessage("Verifying checksum...", 2000);
 
 	unsigned char gameMD5[16];
-	mbedtls_md_file(s_md5_info, SConfig::GetInstance().m_strFilename.c_str(), gameMD5);
-
-	if (memcmp(gameMD5,s_MD5,16) == 0)
+	if (GetGameMD5(gameMD5) && memcmp(gameMD5,s_MD5,16) == 0)
 		Core::DisplayMessage("Checksum of current game matches the recorded game.", 2000);
 	else
 		Core::DisplayMessage("Checksum of current game does not match the recorded game!", 3000);
@@ -1396,8 +1582,10 @@ void CheckMD5()
 void GetMD5()
 {
 	Core::DisplayMessage("Calculating checksum of game file...", 2000);
-	memset(s_MD5, 0, sizeof(s_MD5));
-	mbedtls_md_file(s_md5_info, SConfig::GetInstance().m_strFilename.c_str(), s_MD5);
+	u8 md5[16];
+	if (!GetGameMD5(md5))
+		memset(md5, 0, sizeof(md5));
+	memcpy(s_MD5, md5, sizeof(s_MD5));
 	Core::DisplayMessage("Finished calculating checksum.", 2000);
 }
 
@@ -8,16 +8,21 @@
 #include "Common/CommonTypes.h"
 #include "Common/ENetUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
 #include "Common/Timer.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/Movie.h"
 #include "Core/NetPlayClient.h"
+#include "Core/State.h"
+#include "Core/HW/CPU.h"
 #include "Core/HW/EXI_DeviceIPL.h"
 #include "Core/HW/SI.h"
 #include "Core/HW/SI_DeviceGCController.h"
 #include "Core/HW/Sram.h"
 #include "Core/HW/WiimoteEmu/WiimoteEmu.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_usb.h"
+#include "VideoCommon/Fifo.h"
 
 static const char* NETPLAY_VERSION = scm_rev_git_str;
 static std::mutex crit_netplay_client;
@@ -323,7 +328,8 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 
 		// Trusting server for good map value (>=0 && <4)
 		// add to pad buffer
-		m_pad_buffer.at(map).Push(pad);
+		m_pad_buffer.at(map).Push(BufferedInput<GCPadStatus>(pad, std::chrono::steady_clock::now()));
+		NotifyBuffers();
 	}
 	break;
 
@@ -341,7 +347,8 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 
 		// Trusting server for good map value (>=0 && <4)
 		// add to Wiimote buffer
-		m_wiimote_buffer.at(map).Push(nw);
+		m_wiimote_buffer.at(map).Push(BufferedInput<NetWiimote>(nw, std::chrono::steady_clock::now()));
+		NotifyBuffers();
 	}
 	break;
 
@@ -389,6 +396,7 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 			g_NetPlaySettings.m_EXIDevice[0] = (TEXIDevices)tmp;
 			packet >> tmp;
 			g_NetPlaySettings.m_EXIDevice[1] = (TEXIDevices)tmp;
+			packet >> g_NetPlaySettings.m_Rollback;
 
 			u32 time_low, time_high;
 			packet >> time_low;
@@ -410,6 +418,7 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 	{
 		PanicAlertT("Other client disconnected while game is running!! NetPlay is disabled. You must manually stop the game.");
 		m_is_running.store(false);
+		NotifyBuffers();
 		NetPlay_Disable();
 	}
 	break;
@@ -540,12 +549,22 @@ void NetPlayClient::ThreadFunc()
 		int net;
 		if (m_traversal_client)
 			m_traversal_client->HandleResends();
-		net = enet_host_service(m_client, &netEvent, 250);
+		net = enet_host_service(m_client, &netEvent, m_delayed_packets.empty() ? 250 : 1);
+		const auto now = std::chrono::steady_clock::now();
 		while (!m_async_queue.Empty())
 		{
-			Send(*(m_async_queue.Front().get()));
+			const u32 latency = m_simulated_latency_ms.load();
+			if (latency || !m_delayed_packets.empty())
+				m_delayed_packets.emplace_back(now + std::chrono::milliseconds(latency), std::move(m_async_queue.Front()));
+			else
+				Send(*(m_async_queue.Front().get()));
 			m_async_queue.Pop();
 		}
+		while (!m_delayed_packets.empty() && m_delayed_packets.front().first <= now)
+		{
+			Send(*m_delayed_packets.front().second);
+			m_delayed_packets.pop_front();
+		}
 		if (net > 0)
 		{
 			sf::Packet rpac;
@@ -559,6 +578,7 @@ void NetPlayClient::ThreadFunc()
 				break;
 			case ENET_EVENT_TYPE_DISCONNECT:
 				m_is_running.store(false);
+				NotifyBuffers();
 				NetPlay_Disable();
 				m_dialog->AppendChat("< LOST CONNECTION TO SERVER >");
 				PanicAlertT("Lost connection to server!");
@@ -703,6 +723,8 @@ bool NetPlayClient::StartGame(const std::string &path)
 	NetPlay_Enable(this);
 
 	ClearBuffers();
+	m_input_latency.Reset();
+	ResetRollback();
 
 	if (m_dialog->IsRecording())
 	{
@@ -864,6 +886,10 @@ bool NetPlayClient::GetNetPads(const u8 pad_nb, GCPadStatus* pad_status)
 
 	int in_game_num = LocalPadToInGamePad(pad_nb);
 
+	// Wii games keep using the buffer, their Wii Remote input is not predicted.
+	if (g_NetPlaySettings.m_Rollback && !SConfig::GetInstance().bWii)
+		return GetRollbackPad(pad_nb, in_game_num, pad_status);
+
 	// If this in-game pad is one of ours, then update from the
 	// information given.
 	if (in_game_num < 4)
@@ -884,14 +910,8 @@ bool NetPlayClient::GetNetPads(const u8 pad_nb, GCPadStatus* pad_status)
 	// retrieved from NetPlay. This could be the value we pushed
 	// above if we're configured as P1 and the code is trying
 	// to retrieve data for slot 1.
-	while (!m_pad_buffer[pad_nb].Pop(*pad_status))
-	{
-		if (!m_is_running.load())
-			return false;
-
-		// TODO: use a condition instead of sleeping
-		Common::SleepCurrentThread(1);
-	}
+	if (!PopBuffer(m_pad_buffer[pad_nb], *pad_status))
+		return false;
 
 	if (Movie::IsRecordingInput())
 	{
@@ -952,13 +972,9 @@ bool NetPlayClient::WiimoteUpdate(int _number, u8* data, const u8 size)
 
 	} // unlock players
 
-	while (previousSize[_number] == size && !m_wiimote_buffer[_number].Pop(nw))
-	{
-		// wait for receiving thread to push some data
-		Common::SleepCurrentThread(1);
-		if (!m_is_running.load())
-			return false;
-	}
+	// wait for receiving thread to push some data
+	if (previousSize[_number] == size && !PopBuffer(m_wiimote_buffer[_number], nw))
+		return false;
 
 	// Use a blank input, since we may not have any valid input.
 	if (previousSize[_number] != size)
@@ -978,12 +994,8 @@ bool NetPlayClient::WiimoteUpdate(int _number, u8* data, const u8 size)
 		// Clear the buffer and wait for new input, since we probably just changed reporting mode.
 		while (nw.size() != size)
 		{
-			while (!m_wiimote_buffer[_number].Pop(nw))
-			{
-				Common::SleepCurrentThread(1);
-				if (!m_is_running.load())
-					return false;
-			}
+			if (!PopBuffer(m_wiimote_buffer[_number], nw))
+				return false;
 			++tries;
 			if (tries > m_target_buffer_size * 200 / 120)
 				break;
@@ -1002,6 +1014,310 @@ bool NetPlayClient::WiimoteUpdate(int _number, u8* data, const u8 size)
 	return true;
 }
 
+// called from ---CPU--- thread
+// Blocks until input is available, returns false if the game stopped in the meantime.
+template <typename T>
+bool NetPlayClient::PopBuffer(Common::FifoQueue<BufferedInput<T>>& buffer, T& input)
+{
+	BufferedInput<T> buffered;
+	if (!buffer.Pop(buffered))
+	{
+		std::unique_lock<std::mutex> lk(m_buffer_mutex);
+		while (!buffer.Pop(buffered))
+		{
+			if (!m_is_running.load())
+				return false;
+			// Every push and stop notifies, the timeout is only a safety net.
+			m_buffer_cond.wait_for(lk, std::chrono::milliseconds(100));
+		}
+	}
+
+	if (buffered.arrival != std::chrono::steady_clock::time_point())
+		m_input_latency.Add(std::chrono::steady_clock::now() - buffered.arrival);
+	input = std::move(buffered.input);
+	return true;
+}
+
+// called from ---NETPLAY--- thread and whoever stops the game
+void NetPlayClient::NotifyBuffers()
+{
+	// Taking the lock orders this with the CPU thread checking the buffers before it waits.
+	std::lock_guard<std::mutex> lk(m_buffer_mutex);
+	m_buffer_cond.notify_all();
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::GetRollbackPad(u8 pad_nb, u8 in_game_num, GCPadStatus* pad_status)
+{
+	// Our own input is sent right away, there is no input delay in rollback mode.
+	// When emulating frames again, the input that was sent the first time is used.
+	if (in_game_num < 4)
+	{
+		RollbackPad& local = m_rollback_pads[in_game_num];
+		if (local.local_polls++ == local.inputs.size())
+		{
+			local.inputs.push_back(*pad_status);
+			SendPadState(in_game_num, *pad_status);
+		}
+	}
+
+	RollbackPad& pad = m_rollback_pads[pad_nb];
+	const u32 poll = pad.polls;
+	if (poll >= pad.inputs.size())
+	{
+		std::unique_lock<std::mutex> lk(m_buffer_mutex);
+		ReceiveRollbackInput(pad_nb);
+		while (poll >= pad.inputs.size() && !CanPredict(pad_nb))
+		{
+			if (!m_is_running.load())
+				return false;
+			m_buffer_cond.wait_for(lk, std::chrono::milliseconds(100));
+			ReceiveRollbackInput(pad_nb);
+		}
+	}
+
+	if (poll < pad.inputs.size())
+	{
+		*pad_status = pad.inputs[poll];
+	}
+	else
+	{
+		// Assume the player still holds what they held last.
+		if (pad.inputs.empty())
+		{
+			*pad_status = {};
+			pad_status->stickX = GCPadStatus::MAIN_STICK_CENTER_X;
+			pad_status->stickY = GCPadStatus::MAIN_STICK_CENTER_Y;
+			pad_status->substickX = GCPadStatus::C_STICK_CENTER_X;
+			pad_status->substickY = GCPadStatus::C_STICK_CENTER_Y;
+		}
+		else
+		{
+			*pad_status = pad.inputs.back();
+		}
+		pad.predictions.emplace_back(poll, *pad_status);
+	}
+	pad.polls++;
+
+	CPU::RequestSafePoint(RollbackSafePointCallback);
+
+	// Frames that are emulated again would be recorded twice.
+	Movie::CheckPadStatus(pad_status, pad_nb);
+	return true;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::ReceiveRollbackInput(u8 pad_nb)
+{
+	RollbackPad& pad = m_rollback_pads[pad_nb];
+	BufferedInput<GCPadStatus> buffered;
+	while (m_pad_buffer[pad_nb].Pop(buffered))
+	{
+		if (buffered.arrival != std::chrono::steady_clock::time_point())
+			m_input_latency.Add(std::chrono::steady_clock::now() - buffered.arrival);
+
+		const u32 poll = (u32)pad.inputs.size();
+		pad.inputs.push_back(buffered.input);
+		if (!pad.predictions.empty() && pad.predictions.front().first == poll)
+		{
+			const GCPadStatus& a = pad.predictions.front().second;
+			const GCPadStatus& b = buffered.input;
+			if (a.button != b.button || a.analogA != b.analogA || a.analogB != b.analogB ||
+			    a.stickX != b.stickX || a.stickY != b.stickY || a.substickX != b.substickX ||
+			    a.substickY != b.substickY || a.triggerLeft != b.triggerLeft || a.triggerRight != b.triggerRight)
+			{
+				pad.mispredicted_poll = std::min(pad.mispredicted_poll, poll);
+			}
+			pad.predictions.pop_front();
+		}
+	}
+}
+
+// Predicting is only allowed while a snapshot from before the oldest unconfirmed input is kept.
+bool NetPlayClient::CanPredict(u8 pad_nb) const
+{
+	return !m_rollback_snapshots.empty() &&
+	       m_rollback_snapshots.front().polls[pad_nb] <= m_rollback_pads[pad_nb].inputs.size();
+}
+
+// called from ---GUI--- thread, before the game starts
+void NetPlayClient::ResetRollback()
+{
+	m_rollback_pads = {};
+	m_rollback_snapshots.clear();
+	m_safe_point = 0;
+	m_resimulate_until = 0;
+	m_rollbacks.store(0);
+	m_rollback_safe_points.store(0);
+	m_max_rollback_depth.store(0);
+	m_resimulate_us.store(0);
+	m_max_resimulate_us.store(0);
+}
+
+// called from ---CPU--- thread, where savestates can be made
+void NetPlayClient::RollbackSafePoint()
+{
+	for (u8 i = 0; i < 4; i++)
+		ReceiveRollbackInput(i);
+
+	bool mispredicted = false;
+	for (const RollbackPad& pad : m_rollback_pads)
+		mispredicted |= pad.mispredicted_poll != UINT32_MAX;
+
+	if (mispredicted)
+	{
+		// The newest snapshot from before every wrong prediction.
+		auto snapshot = m_rollback_snapshots.rbegin();
+		for (; snapshot != m_rollback_snapshots.rend(); ++snapshot)
+		{
+			bool before = true;
+			for (u32 i = 0; i < 4; i++)
+				before &= snapshot->polls[i] <= m_rollback_pads[i].mispredicted_poll;
+			if (before)
+				break;
+		}
+
+		if (snapshot == m_rollback_snapshots.rend())
+		{
+			// Can't happen as long as CanPredict is respected.
+			PanicAlertT("Netplay rollback needs a snapshot that was already dropped, the game has desynced.");
+			for (RollbackPad& pad : m_rollback_pads)
+				pad.mispredicted_poll = UINT32_MAX;
+		}
+		else
+		{
+			const u32 depth = m_safe_point - snapshot->safe_point;
+			m_rollbacks++;
+			m_rollback_safe_points += depth;
+			if (depth > m_max_rollback_depth.load())
+				m_max_rollback_depth.store(depth);
+
+			// A rollback while emulating frames again still has to catch up to the same point.
+			if (!m_resimulate_until)
+			{
+				m_resimulate_until = m_safe_point + 1;
+				m_resimulate_start = std::chrono::steady_clock::now();
+				Core::SetIsThrottlerTempDisabled(true);
+			}
+
+			// Savestates include whether rendering is on, so this has to come after loading.
+			State::LoadFromBufferForRollback(snapshot->state);
+			Fifo::SetRendering(false);
+			m_safe_point = snapshot->safe_point;
+			for (u32 i = 0; i < 4; i++)
+			{
+				RollbackPad& pad = m_rollback_pads[i];
+				pad.polls = snapshot->polls[i];
+				pad.local_polls = snapshot->local_polls[i];
+				pad.mispredicted_poll = UINT32_MAX;
+				while (!pad.predictions.empty() && pad.predictions.back().first >= pad.polls)
+					pad.predictions.pop_back();
+			}
+			m_rollback_snapshots.erase(snapshot.base(), m_rollback_snapshots.end());
+
+			// The snapshot already is the state at this safe point.
+			return;
+		}
+	}
+
+	m_safe_point++;
+	if (m_resimulate_until && m_safe_point >= m_resimulate_until)
+	{
+		m_resimulate_until = 0;
+		Fifo::SetRendering(true);
+		Core::SetIsThrottlerTempDisabled(false);
+
+		const u32 us = (u32)std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - m_resimulate_start).count();
+		m_resimulate_us += us;
+		if (us > m_max_resimulate_us.load())
+			m_max_resimulate_us.store(us);
+	}
+
+	if (!m_rollback_snapshots.empty() &&
+	    m_safe_point - m_rollback_snapshots.back().safe_point < ROLLBACK_SNAPSHOT_INTERVAL)
+		return;
+
+	RollbackSnapshot snapshot;
+	if (m_rollback_snapshots.size() >= ROLLBACK_SNAPSHOTS)
+	{
+		snapshot = std::move(m_rollback_snapshots.front());
+		m_rollback_snapshots.pop_front();
+	}
+	State::SaveToBuffer(snapshot.state);
+	snapshot.safe_point = m_safe_point;
+	for (u32 i = 0; i < 4; i++)
+	{
+		snapshot.polls[i] = m_rollback_pads[i].polls;
+		snapshot.local_polls[i] = m_rollback_pads[i].local_polls;
+	}
+	m_rollback_snapshots.push_back(std::move(snapshot));
+}
+
+void NetPlayClient::RollbackSafePointCallback()
+{
+	std::lock_guard<std::mutex> lk(crit_netplay_client);
+
+	if (netplay_client)
+		netplay_client->RollbackSafePoint();
+}
+
+// called from ---GUI--- thread
+std::string NetPlayClient::GetRollbackString() const
+{
+	const u32 rollbacks = m_rollbacks.load();
+	if (!rollbacks)
+		return "";
+
+	return StringFromFormat("Rollbacks: %u, %u safe points on average, %u at most, "
+	                        "re-emulated in %u ms on average, %u ms at most",
+	                        rollbacks, m_rollback_safe_points.load() / rollbacks, m_max_rollback_depth.load(),
+	                        (u32)(m_resimulate_us.load() / rollbacks / 1000), m_max_resimulate_us.load() / 1000);
+}
+
+void InputLatencyHistogram::Add(std::chrono::steady_clock::duration latency)
+{
+	u64 ms = std::chrono::duration_cast<std::chrono::milliseconds>(latency).count();
+	u32 bucket = 0;
+	while (bucket < NUM_BUCKETS - 1 && ms >= (1ULL << bucket))
+		bucket++;
+	m_buckets[bucket]++;
+}
+
+void InputLatencyHistogram::Reset()
+{
+	for (auto& bucket : m_buckets)
+		bucket.store(0);
+}
+
+std::string InputLatencyHistogram::ToString() const
+{
+	std::array<u32, NUM_BUCKETS> counts;
+	u64 total = 0;
+	for (u32 i = 0; i < NUM_BUCKETS; i++)
+	{
+		counts[i] = m_buckets[i].load();
+		total += counts[i];
+	}
+	if (!total)
+		return "";
+
+	std::string result = "Input latency:";
+	for (u32 i = 0; i < NUM_BUCKETS; i++)
+	{
+		if (!counts[i])
+			continue;
+		u32 percent = (u32)(counts[i] * 100 / total);
+		if (i == 0)
+			result += StringFromFormat(" <1ms %u%%", percent);
+		else if (i == NUM_BUCKETS - 1)
+			result += StringFromFormat(" >=%ums %u%%", 1u << (i - 1), percent);
+		else
+			result += StringFromFormat(" %u-%ums %u%%", 1u << (i - 1), 1u << i, percent);
+	}
+	return result;
+}
+
 // called from ---GUI--- thread and ---NETPLAY--- thread (client side)
 bool NetPlayClient::StopGame()
 {
@@ -1014,8 +1330,16 @@ bool NetPlayClient::StopGame()
 	m_dialog->AppendChat(" -- STOPPING GAME -- ");
 
 	m_is_running.store(false);
+	NotifyBuffers();
 	NetPlay_Disable();
 
+	// The game may have stopped while frames were emulated again after a rollback.
+	if (g_NetPlaySettings.m_Rollback)
+	{
+		Fifo::SetRendering(true);
+		Core::SetIsThrottlerTempDisabled(false);
+	}
+
 	// stop game
 	m_dialog->StopGame();
 
@@ -6,6 +6,9 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -46,6 +49,21 @@ public:
 	u32         ping;
 };
 
+// Time from remote input arriving on the netplay thread to the CPU thread consuming it.
+class InputLatencyHistogram
+{
+public:
+	// Power of two buckets in milliseconds: <1, 1-2, 2-4, ..., >=256
+	static const u32 NUM_BUCKETS = 10;
+
+	void Add(std::chrono::steady_clock::duration latency);
+	void Reset();
+	std::string ToString() const;
+
+private:
+	std::array<std::atomic<u32>, NUM_BUCKETS> m_buckets{};
+};
+
 class NetPlayClient : public TraversalClientClient
 {
 public:
@@ -71,6 +89,13 @@ public:
 	bool WiimoteUpdate(int _number, u8* data, const u8 size);
 	bool GetNetPads(const u8 pad_nb, GCPadStatus* pad_status);
 
+	// Called from the GUI thread.
+	std::string GetInputLatencyString() const { return m_input_latency.ToString(); }
+	std::string GetRollbackString() const;
+
+	// Holds back everything sent from other threads by this long, for testing on a local connection.
+	void SetSimulatedLatency(u32 ms) { m_simulated_latency_ms.store(ms); }
+
 	void OnTraversalStateChanged() override;
 	void OnConnectReady(ENetAddress addr) override;
 	void OnConnectFailed(u8 reason) override;
@@ -95,8 +120,81 @@ protected:
 
 	Common::FifoQueue<std::unique_ptr<sf::Packet>, false> m_async_queue;
 
-	std::array<Common::FifoQueue<GCPadStatus>, 4> m_pad_buffer;
-	std::array<Common::FifoQueue<NetWiimote >, 4> m_wiimote_buffer;
+	// Input in the pad buffers, remembering when it was received from the server.
+	// Local input has no arrival time.
+	template <typename T>
+	struct BufferedInput
+	{
+		BufferedInput() {}
+		BufferedInput(const T& input_) : input(input_) {}
+		BufferedInput(const T& input_, std::chrono::steady_clock::time_point arrival_)
+			: input(input_), arrival(arrival_) {}
+
+		T input;
+		std::chrono::steady_clock::time_point arrival;
+	};
+
+	template <typename T>
+	bool PopBuffer(Common::FifoQueue<BufferedInput<T>>& buffer, T& input);
+	void NotifyBuffers();
+
+	std::array<Common::FifoQueue<BufferedInput<GCPadStatus>>, 4> m_pad_buffer;
+	std::array<Common::FifoQueue<BufferedInput<NetWiimote>>, 4> m_wiimote_buffer;
+
+	// Wakes the CPU thread when input arrives or the game stops.
+	std::mutex m_buffer_mutex;
+	std::condition_variable m_buffer_cond;
+	InputLatencyHistogram m_input_latency;
+
+	// Rollback mode, GameCube controllers only. Remote input that has not arrived yet is
+	// predicted. When a prediction turns out wrong, the CPU thread loads the newest snapshot
+	// from before that input and emulates the frames since then again without rendering them.
+	// Everything but the statistics belongs to the CPU thread.
+	static const u32 ROLLBACK_SNAPSHOTS = 8;
+	// Saving a state syncs with the GPU thread, so a snapshot is only taken every few safe points.
+	static const u32 ROLLBACK_SNAPSHOT_INTERVAL = 4;
+
+	struct RollbackSnapshot
+	{
+		std::vector<u8> state;
+		u32 safe_point;
+		std::array<u32, 4> polls;
+		std::array<u32, 4> local_polls;
+	};
+
+	struct RollbackPad
+	{
+		// Confirmed input by poll number, for our own pads the input that was sent.
+		std::vector<GCPadStatus> inputs;
+		// Predictions that were used but not confirmed yet, oldest first.
+		std::deque<std::pair<u32, GCPadStatus>> predictions;
+		u32 polls = 0;
+		// How often the local controller that feeds this pad was read.
+		u32 local_polls = 0;
+		u32 mispredicted_poll = UINT32_MAX;
+	};
+
+	bool GetRollbackPad(u8 pad_nb, u8 in_game_num, GCPadStatus* pad_status);
+	void ReceiveRollbackInput(u8 pad_nb);
+	bool CanPredict(u8 pad_nb) const;
+	void ResetRollback();
+	void RollbackSafePoint();
+	static void RollbackSafePointCallback();
+
+	std::array<RollbackPad, 4> m_rollback_pads;
+	std::deque<RollbackSnapshot> m_rollback_snapshots;
+	u32 m_safe_point = 0;
+	u32 m_resimulate_until = 0;
+	std::chrono::steady_clock::time_point m_resimulate_start;
+
+	std::atomic<u32> m_rollbacks{0};
+	std::atomic<u32> m_rollback_safe_points{0};
+	std::atomic<u32> m_max_rollback_depth{0};
+	std::atomic<u64> m_resimulate_us{0};
+	std::atomic<u32> m_max_resimulate_us{0};
+
+	std::atomic<u32> m_simulated_latency_ms{0};
+	std::deque<std::pair<std::chrono::steady_clock::time_point, std::unique_ptr<sf::Packet>>> m_delayed_packets;
 
 	NetPlayUI*   m_dialog = nullptr;
 
@@ -23,6 +23,7 @@ struct NetSettings
 	bool m_OCEnable;
 	float m_OCFactor;
 	TEXIDevices m_EXIDevice[2];
+	bool m_Rollback;
 };
 
 extern NetSettings g_NetPlaySettings;
@@ -735,6 +735,7 @@ bool NetPlayServer::StartGame()
 	*spac << m_settings.m_OCFactor;
 	*spac << m_settings.m_EXIDevice[0];
 	*spac << m_settings.m_EXIDevice[1];
+	*spac << m_settings.m_Rollback;
 	*spac << (u32)g_netplay_initial_gctime;
 	*spac << (u32)(g_netplay_initial_gctime >> 32);
 
@@ -11,6 +11,7 @@
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/PPCTables.h"
 
 void CachedInterpreter::Init()
 {
@@ -46,61 +47,207 @@ void CachedInterpreter::SingleStep()
 	int block = GetBlockNumberFromStartAddress(PC);
 	if (block >= 0)
 	{
-		Instruction* code = (Instruction*)GetCompiledCodeFromBlock(block);
-
-		while (true)
-		{
-			switch (code->type)
-			{
-			case Instruction::INSTRUCTION_ABORT:
-				return;
-
-			case Instruction::INSTRUCTION_TYPE_COMMON:
-				code->common_callback(UGeckoInstruction(code->data));
-				code++;
-				break;
-
-			case Instruction::INSTRUCTION_TYPE_CONDITIONAL:
-				bool ret = code->conditional_callback(code->data);
-				code++;
-				if (ret)
-					return;
-				break;
-			}
-		}
+		const Instruction* code = (const Instruction*)GetCompiledCodeFromBlock(block);
+		while (code)
+			code = code->handler(code);
+		return;
 	}
 
 	Jit(PC);
 }
 
-static void EndBlock(UGeckoInstruction data)
+const CachedInterpreter::Instruction* CachedInterpreter::Abort(const Instruction* code)
+{
+	return nullptr;
+}
+
+const CachedInterpreter::Instruction* CachedInterpreter::RunInterpreterOp(const Instruction* code)
+{
+	code->callback(UGeckoInstruction(code->data));
+	return code + 1;
+}
+
+const CachedInterpreter::Instruction* CachedInterpreter::EndBlock(const Instruction* code)
 {
 	PC = NPC;
 	PowerPC::CheckExceptions();
-	PowerPC::ppcState.downcount -= data.hex;
+	PowerPC::ppcState.downcount -= code->data;
 	if (PowerPC::ppcState.downcount <= 0)
 	{
 		CoreTiming::Advance();
 	}
+	return code + 1;
 }
 
-static void WritePC(UGeckoInstruction data)
+const CachedInterpreter::Instruction* CachedInterpreter::WritePC(const Instruction* code)
 {
-	PC = data.hex;
-	NPC = data.hex + 4;
+	PC = code->data;
+	NPC = code->data + 4;
+	return code + 1;
 }
 
-static bool CheckFPU(u32 data)
+const CachedInterpreter::Instruction* CachedInterpreter::CheckFPU(const Instruction* code)
 {
 	UReg_MSR& msr = (UReg_MSR&)MSR;
 	if (!msr.FP)
 	{
-		PC = NPC = data;
+		PC = NPC = code->data;
 		PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
 		PowerPC::CheckExceptions();
-		return true;
+		return nullptr;
 	}
-	return false;
+	return code + 1;
+}
+
+// addi/addis with rA != 0, the immediate is already shifted for addis
+const CachedInterpreter::Instruction* CachedInterpreter::AddImmediate(const Instruction* code)
+{
+	rGPR[code->rd] = rGPR[code->ra] + code->imm;
+	return code + 1;
+}
+
+// li/lis
+const CachedInterpreter::Instruction* CachedInterpreter::LoadImmediate(const Instruction* code)
+{
+	rGPR[code->rd] = code->imm;
+	return code + 1;
+}
+
+const CachedInterpreter::Instruction* CachedInterpreter::LoadWord(const Instruction* code)
+{
+	u32 temp = PowerPC::Read_U32((code->ra ? rGPR[code->ra] : 0) + code->imm);
+	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
+		rGPR[code->rd] = temp;
+	return code + 1;
+}
+
+const CachedInterpreter::Instruction* CachedInterpreter::StoreWord(const Instruction* code)
+{
+	PowerPC::Write_U32(rGPR[code->rd], (code->ra ? rGPR[code->ra] : 0) + code->imm);
+	return code + 1;
+}
+
+// lwz followed by a compare of the loaded register
+const CachedInterpreter::Instruction* CachedInterpreter::LoadAndCompare(const Instruction* code)
+{
+	LoadWord(code);
+	code->callback(UGeckoInstruction(code->data));
+	return code + 1;
+}
+
+// cmp(l)i followed by a bc on the field it set; the EndBlock of the branch comes next.
+const CachedInterpreter::Instruction* CachedInterpreter::CompareAndBranch(const Instruction* code)
+{
+	code->callback(UGeckoInstruction(code->data));
+	NPC = GetCRBit(code->bi) == code->bi_value ? code->target : code->imm;
+	return code + 1;
+}
+
+bool CachedInterpreter::CanFuseWith(const PPCAnalyst::CodeOp& op) const
+{
+	return !op.skip && !(op.opinfo->flags & FL_USE_FPU) && HLE::GetFunctionIndex(op.address) == 0;
+}
+
+u32 CachedInterpreter::CompileInstruction(PPCAnalyst::CodeOp* ops, u32 i, u32 count)
+{
+	const PPCAnalyst::CodeOp& op = ops[i];
+	const UGeckoInstruction inst = op.inst;
+	const PPCAnalyst::CodeOp* next = i + 1 < count && CanFuseWith(ops[i + 1]) ? &ops[i + 1] : nullptr;
+	// Like the JITs, fall back to the plain interpreter functions for the disabled categories.
+	const SConfig& config = SConfig::GetInstance();
+
+	switch (inst.OPCD)
+	{
+	case 14: // addi
+	case 15: // addis
+	{
+		if (config.bJITOff || config.bJITIntegerOff)
+			break;
+		Instruction add(inst.RA ? AddImmediate : LoadImmediate, inst.hex);
+		add.rd = inst.RD;
+		add.ra = inst.RA;
+		add.imm = inst.OPCD == 15 ? (u32)inst.SIMM_16 << 16 : (u32)SignExt16(inst.SIMM_16);
+
+		// Fold chains like "lis rX, hi; addi rX, rX, lo" into a single add.
+		u32 consumed = 1;
+		while (i + consumed < count && CanFuseWith(ops[i + consumed]))
+		{
+			const PPCAnalyst::CodeOp& chained = ops[i + consumed];
+			const UGeckoInstruction c = chained.inst;
+			if ((c.OPCD != 14 && c.OPCD != 15) || c.RA == 0 || c.RA != add.rd || c.RD != add.rd)
+				break;
+			add.imm += c.OPCD == 15 ? (u32)c.SIMM_16 << 16 : (u32)SignExt16(c.SIMM_16);
+			js.downcountAmount += chained.opinfo->numCycles;
+			consumed++;
+		}
+		m_code.push_back(add);
+		return consumed;
+	}
+
+	case 32: // lwz
+	{
+		if (config.bJITOff || config.bJITLoadStoreOff || config.bJITLoadStorelwzOff)
+			break;
+		Instruction load(LoadWord, inst.hex);
+		load.rd = inst.RD;
+		load.ra = inst.RA;
+		load.imm = (u32)SignExt16(inst.SIMM_16);
+		if (next && (next->inst.OPCD == 10 || next->inst.OPCD == 11) && next->inst.RA == inst.RD)
+		{
+			load.handler = LoadAndCompare;
+			load.callback = GetInterpreterOp(next->inst);
+			load.data = next->inst.hex;
+			js.downcountAmount += next->opinfo->numCycles;
+			m_code.push_back(load);
+			return 2;
+		}
+		m_code.push_back(load);
+		return 1;
+	}
+
+	case 36: // stw
+	{
+		if (config.bJITOff || config.bJITLoadStoreOff)
+			break;
+		Instruction store(StoreWord, inst.hex);
+		store.rd = inst.RS;
+		store.ra = inst.RA;
+		store.imm = (u32)SignExt16(inst.SIMM_16);
+		m_code.push_back(store);
+		return 1;
+	}
+
+	case 10: // cmpli
+	case 11: // cmpi
+	{
+		if (config.bJITOff || config.bJITBranchOff || !next || next->inst.OPCD != 16)
+			break;
+		// Only plain conditional branches on the field that was just set. The beq -8 idle loop
+		// is left to Interpreter::bcx, which detects it.
+		const UGeckoInstruction branch = next->inst;
+		if (!(branch.BO & BO_DONT_DECREMENT_FLAG) || (branch.BO & BO_DONT_CHECK_CONDITION) ||
+		    branch.LK || (branch.BI >> 2) != inst.CRFD || branch.hex == 0x4182fff8)
+			break;
+
+		Instruction fused(CompareAndBranch, inst.hex);
+		fused.callback = GetInterpreterOp(inst);
+		fused.bi = branch.BI;
+		fused.bi_value = (branch.BO >> 3) & 1;
+		fused.imm = next->address + 4;
+		fused.target = SignExt16(branch.BD << 2) + (branch.AA ? 0 : next->address);
+		js.downcountAmount += next->opinfo->numCycles;
+		m_code.push_back(fused);
+		m_code.emplace_back(EndBlock, js.downcountAmount);
+		return 2;
+	}
+	}
+
+	if (op.opinfo->flags & FL_ENDBLOCK)
+		m_code.emplace_back(WritePC, op.address);
+	m_code.emplace_back(GetInterpreterOp(inst), inst);
+	if (op.opinfo->flags & FL_ENDBLOCK)
+		m_code.emplace_back(EndBlock, js.downcountAmount);
+	return 1;
 }
 
 void CachedInterpreter::Jit(u32 address)
@@ -136,7 +283,7 @@ void CachedInterpreter::Jit(u32 address)
 	b->normalEntry = GetCodePtr();
 	b->runCount = 0;
 
-	for (u32 i = 0; i < code_block.m_num_instructions; i++)
+	for (u32 i = 0; i < code_block.m_num_instructions;)
 	{
 		js.downcountAmount += ops[i].opinfo->numCycles;
 
@@ -161,20 +308,19 @@ void CachedInterpreter::Jit(u32 address)
 			}
 		}
 
-		if (!ops[i].skip)
+		if (ops[i].skip)
 		{
-			if ((ops[i].opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound)
-			{
-				m_code.emplace_back(CheckFPU, ops[i].address);
-				js.firstFPInstructionFound = true;
-			}
+			i++;
+			continue;
+		}
 
-			if (ops[i].opinfo->flags & FL_ENDBLOCK)
-				m_code.emplace_back(WritePC, ops[i].address);
-			m_code.emplace_back(GetInterpreterOp(ops[i].inst), ops[i].inst);
-			if (ops[i].opinfo->flags & FL_ENDBLOCK)
-				m_code.emplace_back(EndBlock, js.downcountAmount);
+		if ((ops[i].opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound)
+		{
+			m_code.emplace_back(CheckFPU, ops[i].address);
+			js.firstFPInstructionFound = true;
 		}
+
+		i += CompileInstruction(ops, i, code_block.m_num_instructions);
 	}
 	if (code_block.m_broken)
 	{
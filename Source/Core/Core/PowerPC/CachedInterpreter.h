@@ -8,6 +8,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 class CachedInterpreter : public JitBase, JitBaseBlockCache
@@ -42,30 +43,49 @@ public:
 	const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; };
 
 private:
+	// Blocks are compiled to an array of Instructions run by calling each handler in turn.
+	// A handler returns the instruction to run next, or nullptr once the block is done, so
+	// the dispatch loop never needs to look at what kind of entry it is running.
 	struct Instruction
 	{
-		typedef void (*CommonCallback)(UGeckoInstruction);
-		typedef bool (*ConditionalCallback)(u32 data);
-
-		Instruction() : type(INSTRUCTION_ABORT) {};
-		Instruction(const CommonCallback c, UGeckoInstruction i) : common_callback(c), data(i.hex), type(INSTRUCTION_TYPE_COMMON) {};
-		Instruction(const ConditionalCallback c, u32 d) : conditional_callback(c), data(d), type(INSTRUCTION_TYPE_CONDITIONAL) {};
-
-		union
-		{
-			const CommonCallback common_callback;
-			const ConditionalCallback conditional_callback;
-
-		};
-		u32 data;
-		enum
-		{
-			INSTRUCTION_ABORT,
-			INSTRUCTION_TYPE_COMMON,
-			INSTRUCTION_TYPE_CONDITIONAL,
-		} type;
+		typedef const Instruction* (*Handler)(const Instruction* code);
+
+		Instruction() : handler(Abort) {}
+		Instruction(Handler h, u32 d) : handler(h), data(d) {}
+		Instruction(Interpreter::Instruction op, UGeckoInstruction i)
+			: handler(RunInterpreterOp), callback(op), data(i.hex) {}
+
+		Handler handler;
+		// Interpreter function run by RunInterpreterOp and the fused handlers.
+		Interpreter::Instruction callback = nullptr;
+		// The instruction word, or the argument of a helper.
+		u32 data = 0;
+		// Operands decoded when the block is compiled.
+		u32 imm = 0;
+		u32 target = 0;
+		u8 rd = 0;
+		u8 ra = 0;
+		u8 bi = 0;
+		u8 bi_value = 0;
 	};
 
+	static const Instruction* Abort(const Instruction* code);
+	static const Instruction* RunInterpreterOp(const Instruction* code);
+	static const Instruction* EndBlock(const Instruction* code);
+	static const Instruction* WritePC(const Instruction* code);
+	static const Instruction* CheckFPU(const Instruction* code);
+	static const Instruction* AddImmediate(const Instruction* code);
+	static const Instruction* LoadImmediate(const Instruction* code);
+	static const Instruction* LoadWord(const Instruction* code);
+	static const Instruction* StoreWord(const Instruction* code);
+	static const Instruction* LoadAndCompare(const Instruction* code);
+	static const Instruction* CompareAndBranch(const Instruction* code);
+
+	// Emits the instruction at ops[i], fused with ops[i + 1] where possible.
+	// Returns the number of guest instructions consumed.
+	u32 CompileInstruction(PPCAnalyst::CodeOp* ops, u32 i, u32 count);
+	bool CanFuseWith(const PPCAnalyst::CodeOp& op) const;
+
 	const u8* GetCodePtr() { return (u8*)(m_code.data() + m_code.size()); }
 
 	std::vector<Instruction> m_code;
@@ -151,6 +151,8 @@ inline double NI_sub(double a, double b)
 // FMA instructions on PowerPC are weird:
 // They calculate (a * c) + b, but the order in which
 // inputs are checked for NaN is still a, b, c.
+// The product is not rounded before the addition, which std::fma matches
+// exactly (and which Jit64 gets from FMA3).
 inline double NI_madd(double a, double c, double b)
 {
 	double t = a * c;
@@ -162,7 +164,7 @@ inline double NI_madd(double a, double c, double b)
 		SetFPException(FPSCR_VXIMZ);
 		return PPC_NAN;
 	}
-	t += b;
+	t = std::fma(a, c, b);
 	if (std::isnan(t))
 	{
 		if (std::isnan(b)) return MakeQuiet(b);
@@ -184,7 +186,7 @@ inline double NI_msub(double a, double c, double b)
 		return PPC_NAN;
 	}
 
-	t -= b;
+	t = std::fma(a, c, -b);
 	if (std::isnan(t))
 	{
 		if (std::isnan(b)) return MakeQuiet(b);
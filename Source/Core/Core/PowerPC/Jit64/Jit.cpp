@@ -208,9 +208,11 @@ void Jit64::Init()
 
 	jo.optimizeGatherPipe = true;
 	jo.accurateSinglePrecision = true;
+	jo.hotTraces = SConfig::GetInstance().bJITHotTraces && !SConfig::GetInstance().bEnableDebugging;
 	UpdateMemoryOptions();
 	js.fastmemLoadStore = nullptr;
 	js.compilerPC = 0;
+	js.hotTrace = false;
 
 	gpr.SetEmitter(this);
 	fpr.SetEmitter(this);
@@ -238,6 +240,7 @@ void Jit64::Init()
 	code_block.m_stats = &js.st;
 	code_block.m_gpa = &js.gpa;
 	code_block.m_fpa = &js.fpa;
+	analyzer.SetBranchProfile(&js.branchProfile);
 	EnableOptimization();
 }
 
@@ -247,6 +250,7 @@ void Jit64::ClearCache()
 	trampolines.ClearCodeSpace();
 	farcode.ClearCodeSpace();
 	ClearCodeSpace();
+	js.branchProfile.clear();
 	Clear();
 	UpdateMemoryOptions();
 }
@@ -309,6 +313,9 @@ void Jit64::DoNothing(UGeckoInstruction _inst)
 	// Yup, just don't do anything.
 }
 
+// Entries into a profiled block before it is recompiled as a hot trace.
+static const u32 HOT_TRACE_THRESHOLD = 2000;
+
 static const bool ImHereDebug = false;
 static const bool ImHereLog = false;
 static std::map<u32, int> been_here;
@@ -375,6 +382,16 @@ void Jit64::WriteExit(u32 destination, bool bl, u32 after)
 	JustWriteExit(destination, bl, after);
 }
 
+void Jit64::ProfileBranch(u32 address, bool taken)
+{
+	if (!jo.hotTraces || js.hotTrace)
+		return;
+
+	PPCAnalyst::BranchProfile& profile = js.branchProfile[address];
+	MOV(64, R(RSCRATCH), Imm64((u64)(taken ? &profile.taken : &profile.notTaken)));
+	ADD(32, MatR(RSCRATCH), Imm8(1));
+}
+
 void Jit64::JustWriteExit(u32 destination, bool bl, u32 after)
 {
 	//If nobody has taken care of this yet (this can be removed when all branches are done)
@@ -484,6 +501,21 @@ void Jit64::WriteExceptionExit()
 	JMP(asm_routines.dispatcher, true);
 }
 
+bool Jit64::CanSkipIdleLoop(const PPCAnalyst::CodeOp& op) const
+{
+	return op.branchIsIdleLoop && SConfig::GetInstance().bSkipIdle &&
+	       PowerPC::GetState() != PowerPC::CPU_STEPPING;
+}
+
+void Jit64::WriteIdleExit(u32 destination)
+{
+	ABI_PushRegistersAndAdjustStack({}, 0);
+	ABI_CallFunction((void *)&CoreTiming::Idle);
+	ABI_PopRegistersAndAdjustStack({}, 0);
+	MOV(32, PPCSTATE(pc), Imm32(destination));
+	WriteExceptionExit();
+}
+
 void Jit64::WriteExternalExceptionExit()
 {
 	Cleanup();
@@ -576,6 +608,15 @@ void Jit64::Jit(u32 em_address)
 		}
 	}
 
+	// Blocks start out profiled; once one got hot, it is rebuilt as a trace along the
+	// branches the profile says are taken.
+	js.hotTrace = jo.hotTraces && blockSize > 1 &&
+	              js.hotTraceAddresses.find(em_address) != js.hotTraceAddresses.end();
+	if (js.hotTrace)
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_HOT_TRACE);
+	else
+		analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_HOT_TRACE);
+
 	// Analyze the block, collect all instructions it is made of (including inlining,
 	// if that is enabled), reorder instructions for optimal performance, and join joinable instructions.
 	u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
@@ -638,6 +679,23 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		// get start tic
 		PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
 	}
+
+	// Count down the entries of profiled blocks; at zero, have the block rebuilt as a trace.
+	if (jo.hotTraces && !js.hotTrace)
+	{
+		b->hotCountdown = HOT_TRACE_THRESHOLD;
+		MOV(64, R(RSCRATCH), Imm64((u64)&b->hotCountdown));
+		SUB(32, MatR(RSCRATCH), Imm8(1));
+		FixupBranch hot = J_CC(CC_Z, true);
+		SwitchToFarCode();
+			SetJumpTarget(hot);
+			MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+			ABI_PushRegistersAndAdjustStack({}, 0);
+			ABI_CallFunction((void *)&JitInterface::CompileHotTrace);
+			ABI_PopRegistersAndAdjustStack({}, 0);
+			JMP(asm_routines.dispatcher, true);
+		SwitchToNearCode();
+	}
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
 	// should help logged stack-traces become more accurate
 	MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -655,34 +713,36 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	js.skipInstructions = 0;
 	js.carryFlagSet = false;
 	js.carryFlagInverted = false;
-	js.assumeNoPairedQuantize = false;
+	js.constantGqr = BitSet8(0);
 
-	// If the block only uses one GQR and the GQR is zero at compile time, make a guess that the block
-	// never uses quantized loads/stores. Many paired-heavy games use largely float loads and stores,
-	// which are significantly faster when inlined (especially in MMU mode, where this lets them use
+	// Games almost never change the GQRs once set up, so guess that the GQRs a block uses but does
+	// not write keep the value they have at compile time. This lets paired loads/stores be compiled
+	// for one quantization type and scale instead of going through the lookup tables; unquantized
+	// ones are significantly faster when inlined (especially in MMU mode, where this lets them use
 	// fastmem).
-	// Insert a check that the GQR is still zero at the start of the block in case our guess turns out
-	// wrong.
-	// TODO: support any other constant GQR value, not merely zero/unquantized: we can optimize quantized
-	// loadstores too, it'd just be more code.
-	if (code_block.m_gqr_used.Count() == 1 && js.pairedQuantizeAddresses.find(js.blockStart) == js.pairedQuantizeAddresses.end())
+	// Insert a check that the GQRs still hold these values at the start of the block in case our
+	// guess turns out wrong; the block is then recompiled without the guess.
+	BitSet8 gqr_static = code_block.m_gqr_used & ~code_block.m_gqr_modified;
+	if (gqr_static && js.pairedQuantizeAddresses.find(js.blockStart) == js.pairedQuantizeAddresses.end())
 	{
-		int gqr = *code_block.m_gqr_used.begin();
-		if (!code_block.m_gqr_modified[gqr] && !GQR(gqr))
+		SwitchToFarCode();
+			const u8* failure = GetCodePtr();
+			MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+			ABI_PushRegistersAndAdjustStack({}, 0);
+			ABI_CallFunctionC((void *)&JitInterface::CompileExceptionCheck,
+			                  (u32)JitInterface::ExceptionType::EXCEPTIONS_PAIRED_QUANTIZE);
+			ABI_PopRegistersAndAdjustStack({}, 0);
+			JMP(asm_routines.dispatcher, true);
+		SwitchToNearCode();
+
+		for (int gqr : gqr_static)
 		{
-			CMP(32, PPCSTATE(spr[SPR_GQR0 + gqr]), Imm8(0));
-			FixupBranch failure = J_CC(CC_NZ, true);
-			SwitchToFarCode();
-				SetJumpTarget(failure);
-				MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
-				ABI_PushRegistersAndAdjustStack({}, 0);
-				ABI_CallFunctionC((void *)&JitInterface::CompileExceptionCheck,
-				                  (u32)JitInterface::ExceptionType::EXCEPTIONS_PAIRED_QUANTIZE);
-				ABI_PopRegistersAndAdjustStack({}, 0);
-				JMP(asm_routines.dispatcher, true);
-			SwitchToNearCode();
-			js.assumeNoPairedQuantize = true;
+			u32 value = GQR(gqr);
+			js.constantGqrValue[gqr] = value;
+			CMP_or_TEST(32, PPCSTATE(spr[SPR_GQR0 + gqr]), Imm32(value));
+			J_CC(CC_NZ, failure);
 		}
+		js.constantGqr = gqr_static;
 	}
 
 	// Translate instructions
@@ -915,6 +975,8 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 
 	b->codeSize = (u32)(GetCodePtr() - start);
 	b->originalSize = code_block.m_num_instructions;
+	if (code_block.m_ranges.size() > 1)
+		b->codeRanges = code_block.m_ranges;
 
 #ifdef JIT_LOG_X86
 	LogGeneratedX86(code_block.m_num_instructions, code_buf, start, b);
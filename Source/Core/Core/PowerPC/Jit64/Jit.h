@@ -96,8 +96,14 @@ public:
 	void WriteExceptionExit();
 	void WriteExternalExceptionExit();
 	void WriteRfiExitDestInRSCRATCH();
+	// For a branch closing a polling loop: skips ahead to the next event instead of spinning.
+	bool CanSkipIdleLoop(const PPCAnalyst::CodeOp& op) const;
+	void WriteIdleExit(u32 destination);
 	bool Cleanup();
 
+	// Counts which way a conditional branch went, for forming hot traces. Clobbers flags.
+	void ProfileBranch(u32 address, bool taken);
+
 	void GenerateConstantOverflow(bool overflow);
 	void GenerateConstantOverflow(s64 val);
 	void GenerateOverflow();
@@ -142,6 +148,11 @@ public:
 	void FloatCompare(UGeckoInstruction inst, bool upper = false);
 	void UpdateMXCSR();
 
+	// Inline versions of the quantized load/store routines for a GQR value known at compile time.
+	// Same ins/outs as the routines: address in RSCRATCH_EXTRA, value in XMM0. Trashes XMM1.
+	void GenQuantizedLoad(bool single, EQuantizeType type, u32 scale);
+	void GenQuantizedStore(bool single, EQuantizeType type, u32 scale);
+
 	// OPCODES
 	using Instruction = void (Jit64::*)(UGeckoInstruction instCode);
 	void FallBackToInterpreter(UGeckoInstruction _inst);
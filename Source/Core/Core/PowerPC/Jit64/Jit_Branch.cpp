@@ -126,6 +126,21 @@ void Jit64::bcx(UGeckoInstruction inst)
 		                                        !(inst.BO_2 & BO_BRANCH_IF_TRUE));
 	}
 
+	// Hot trace: the block goes on at the destination, so only the fall-through leaves it.
+	if (js.op->branchIsFollowed)
+	{
+		SwitchToFarCode();
+			if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
+				SetJumpTarget(pConditionDontBranch);
+			if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
+				SetJumpTarget(pCTRDontBranch);
+			gpr.Flush(FLUSH_MAINTAIN_STATE);
+			fpr.Flush(FLUSH_MAINTAIN_STATE);
+			WriteExit(js.compilerPC + 4);
+		SwitchToNearCode();
+		return;
+	}
+
 	if (inst.LK)
 		MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));
 
@@ -135,14 +150,22 @@ void Jit64::bcx(UGeckoInstruction inst)
 	else
 		destination = js.compilerPC + SignExt16(inst.BD << 2);
 
+	bool conditional = (inst.BO & BO_DONT_CHECK_CONDITION) == 0 || (inst.BO & BO_DONT_DECREMENT_FLAG) == 0;
+	if (conditional)
+		ProfileBranch(js.compilerPC, true);
 	gpr.Flush(FLUSH_MAINTAIN_STATE);
 	fpr.Flush(FLUSH_MAINTAIN_STATE);
-	WriteExit(destination, inst.LK, js.compilerPC + 4);
+	if (CanSkipIdleLoop(*js.op))
+		WriteIdleExit(destination);
+	else
+		WriteExit(destination, inst.LK, js.compilerPC + 4);
 
 	if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
 		SetJumpTarget(pConditionDontBranch);
 	if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
 		SetJumpTarget(pCTRDontBranch);
+	if (conditional)
+		ProfileBranch(js.compilerPC, false);
 
 	if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
 	{
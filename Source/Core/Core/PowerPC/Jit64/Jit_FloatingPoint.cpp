@@ -222,6 +222,10 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITFloatingPointOff);
 	FALLBACK_IF(inst.Rc);
+	// Gekko does not round the product before the addition. FMA3 gives the same result as the
+	// interpreter (which uses std::fma); the separate multiply and add below does not, so
+	// deterministic mode can't use it without desyncing from hosts that have FMA3.
+	FALLBACK_IF(!cpu_info.bFMA && Core::g_want_determinism);
 
 	int a = inst.FA;
 	int b = inst.FB;
@@ -250,7 +254,7 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 			Force25BitPrecision(XMM1, R(XMM1), XMM0);
 		break;
 	default:
-		bool special = inst.SUBOP5 == 30 && (!cpu_info.bFMA || Core::g_want_determinism);
+		bool special = inst.SUBOP5 == 30 && !cpu_info.bFMA;
 		X64Reg tmp1 = special ? XMM0 : XMM1;
 		X64Reg tmp2 = special ? XMM1 : XMM0;
 		if (single && round_input)
@@ -260,13 +264,7 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 		break;
 	}
 
-	// While we don't know if any games are actually affected (replays seem to work with all the usual
-	// suspects for desyncing), netplay and other applications need absolute perfect determinism, so
-	// be extra careful and don't use FMA, even if in theory it might be okay.
-	// Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
-	// to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
-	// instances on different computers giving identical results.
-	if (cpu_info.bFMA && !Core::g_want_determinism)
+	if (cpu_info.bFMA)
 	{
 		// Statistics suggests b is a lot less likely to be unbound in practice, so
 		// if we have to pick one of a or b to bind, let's make it b.
@@ -274,6 +272,7 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 		switch (inst.SUBOP5)
 		{
 		case 28: //msub
+		case 30: //nmsub
 			if (packed)
 				VFMSUB132PD(XMM1, fpr.RX(b), fpr.R(a));
 			else
@@ -282,28 +281,19 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 		case 14: //madds0
 		case 15: //madds1
 		case 29: //madd
+		case 31: //nmadd
 			if (packed)
 				VFMADD132PD(XMM1, fpr.RX(b), fpr.R(a));
 			else
 				VFMADD132SD(XMM1, fpr.RX(b), fpr.R(a));
 			break;
-			// PowerPC and x86 define NMADD/NMSUB differently
-			// x86: D = -A*C (+/-) B
-			// PPC: D = -(A*C (+/-) B)
-			// so we have to swap them; the ADD/SUB here isn't a typo.
-		case 30: //nmsub
-			if (packed)
-				VFNMADD132PD(XMM1, fpr.RX(b), fpr.R(a));
-			else
-				VFNMADD132SD(XMM1, fpr.RX(b), fpr.R(a));
-			break;
-		case 31: //nmadd
-			if (packed)
-				VFNMSUB132PD(XMM1, fpr.RX(b), fpr.R(a));
-			else
-				VFNMSUB132SD(XMM1, fpr.RX(b), fpr.R(a));
-			break;
 		}
+		// PowerPC and x86 define NMADD/NMSUB differently
+		// x86: D = -A*C (+/-) B
+		// PPC: D = -(A*C (+/-) B)
+		// which differ in the sign of an exact zero, so negate the PPC way.
+		if (inst.SUBOP5 == 30 || inst.SUBOP5 == 31)
+			PXOR(XMM1, M(packed ? psSignBits2 : psSignBits));
 	}
 	else if (inst.SUBOP5 == 30) //nmsub
 	{
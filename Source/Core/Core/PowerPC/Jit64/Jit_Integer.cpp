@@ -341,6 +341,10 @@ bool Jit64::CheckMergedBranch(int crf)
 	if (!MergeAllowedNextInstructions(1))
 		return false;
 
+	// Branches a hot trace goes through are compiled by bcx itself.
+	if (js.op[1].branchIsFollowed)
+		return false;
+
 	const UGeckoInstruction& next = js.op[1].inst;
 	return (((next.OPCD == 16 /* bcx */) ||
 	        ((next.OPCD == 19) && (next.SUBOP10 == 528) /* bcctrx */) ||
@@ -365,7 +369,10 @@ void Jit64::DoMergedBranch()
 			destination = SignExt16(next.BD << 2);
 		else
 			destination = nextPC + SignExt16(next.BD << 2);
-		WriteExit(destination, next.LK, nextPC + 4);
+		if (CanSkipIdleLoop(js.op[1]))
+			WriteIdleExit(destination);
+		else
+			WriteExit(destination, next.LK, nextPC + 4);
 	}
 	else if ((next.OPCD == 19) && (next.SUBOP10 == 528)) // bcctrx
 	{
@@ -411,12 +418,16 @@ void Jit64::DoMergedBranchCondition()
 	else  // SO bit, do not branch (we don't emulate SO for cmp).
 		pDontBranch = J(true);
 
+	if (next.OPCD == 16)
+		ProfileBranch(nextPC, true);
 	gpr.Flush(FLUSH_MAINTAIN_STATE);
 	fpr.Flush(FLUSH_MAINTAIN_STATE);
 
 	DoMergedBranch();
 
 	SetJumpTarget(pDontBranch);
+	if (next.OPCD == 16)
+		ProfileBranch(nextPC, false);
 
 	if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
 	{
@@ -18,6 +18,13 @@
 
 using namespace Gen;
 
+alignas(16) static const float m_65535[4] = {65535.0f, 65535.0f, 65535.0f, 65535.0f};
+static const float m_32767 = 32767.0f;
+static const float m_m32768 = -32768.0f;
+static const float m_255 = 255.0f;
+static const float m_127 = 127.0f;
+static const float m_m128 = -128.0f;
+
 // The big problem is likely instructions that set the quantizers in the same block.
 // We will have to break block after quantizers are written to.
 void Jit64::psq_stXX(UGeckoInstruction inst)
@@ -35,8 +42,12 @@ void Jit64::psq_stXX(UGeckoInstruction inst)
 	int w = indexed ? inst.Wx : inst.W;
 	FALLBACK_IF(!a);
 
+	// The block checks on entry that the GQR still holds this value, see DoJit.
+	bool constant_gqr = js.constantGqr[i];
+	UGQR gqr(constant_gqr ? js.constantGqrValue[i] : 0);
+
 	gpr.Lock(a, b);
-	if (js.assumeNoPairedQuantize)
+	if (constant_gqr && gqr.st_type == QUANTIZE_FLOAT)
 	{
 		int storeOffset = 0;
 		gpr.BindToRegister(a, true, update);
@@ -123,25 +134,37 @@ void Jit64::psq_stXX(UGeckoInstruction inst)
 	// In memcheck mode, don't update the address until the exception check
 	if (update && !jo.memcheck)
 		MOV(32, gpr.R(a), R(RSCRATCH_EXTRA));
-	// Some games (e.g. Dirt 2) incorrectly set the unused bits which breaks the lookup table code.
-	// Hence, we need to mask out the unused bits. The layout of the GQR register is
-	// UU[SCALE]UUUUU[TYPE] where SCALE is 6 bits and TYPE is 3 bits, so we have to AND with
-	// 0b0011111100000111, or 0x3F07.
-	MOV(32, R(RSCRATCH2), Imm32(0x3F07));
-	AND(32, R(RSCRATCH2), PPCSTATE(spr[SPR_GQR0 + i]));
-	MOVZX(32, 8, RSCRATCH, R(RSCRATCH2));
-
-	if (w)
+
+	if (constant_gqr && gqr.st_type >= QUANTIZE_U8)
 	{
-		// One value
-		CVTSD2SS(XMM0, fpr.R(s));
-		CALLptr(MScaled(RSCRATCH, SCALE_8, (u32)(u64)asm_routines.singleStoreQuantized));
+		if (w)
+			CVTSD2SS(XMM0, fpr.R(s));
+		else
+			CVTPD2PS(XMM0, fpr.R(s));
+		GenQuantizedStore(!!w, gqr.st_type, gqr.st_scale);
 	}
 	else
 	{
-		// Pair of values
-		CVTPD2PS(XMM0, fpr.R(s));
-		CALLptr(MScaled(RSCRATCH, SCALE_8, (u32)(u64)asm_routines.pairedStoreQuantized));
+		// Some games (e.g. Dirt 2) incorrectly set the unused bits which breaks the lookup table code.
+		// Hence, we need to mask out the unused bits. The layout of the GQR register is
+		// UU[SCALE]UUUUU[TYPE] where SCALE is 6 bits and TYPE is 3 bits, so we have to AND with
+		// 0b0011111100000111, or 0x3F07.
+		MOV(32, R(RSCRATCH2), Imm32(0x3F07));
+		AND(32, R(RSCRATCH2), PPCSTATE(spr[SPR_GQR0 + i]));
+		MOVZX(32, 8, RSCRATCH, R(RSCRATCH2));
+
+		if (w)
+		{
+			// One value
+			CVTSD2SS(XMM0, fpr.R(s));
+			CALLptr(MScaled(RSCRATCH, SCALE_8, (u32)(u64)asm_routines.singleStoreQuantized));
+		}
+		else
+		{
+			// Pair of values
+			CVTPD2PS(XMM0, fpr.R(s));
+			CALLptr(MScaled(RSCRATCH, SCALE_8, (u32)(u64)asm_routines.pairedStoreQuantized));
+		}
 	}
 
 	if (update && jo.memcheck)
@@ -171,8 +194,12 @@ void Jit64::psq_lXX(UGeckoInstruction inst)
 	int w = indexed ? inst.Wx : inst.W;
 	FALLBACK_IF(!a);
 
+	// The block checks on entry that the GQR still holds this value, see DoJit.
+	bool constant_gqr = js.constantGqr[i];
+	UGQR gqr(constant_gqr ? js.constantGqrValue[i] : 0);
+
 	gpr.Lock(a, b);
-	if (js.assumeNoPairedQuantize)
+	if (constant_gqr && gqr.ld_type == QUANTIZE_FLOAT)
 	{
 		s32 loadOffset = 0;
 		gpr.BindToRegister(a, true, update);
@@ -300,16 +327,24 @@ void Jit64::psq_lXX(UGeckoInstruction inst)
 	// In memcheck mode, don't update the address until the exception check
 	if (update && !jo.memcheck)
 		MOV(32, gpr.R(a), R(RSCRATCH_EXTRA));
-	MOV(32, R(RSCRATCH2), Imm32(0x3F07));
 
-	// Get the high part of the GQR register
-	OpArg gqr = PPCSTATE(spr[SPR_GQR0 + i]);
-	gqr.AddMemOffset(2);
+	if (constant_gqr && gqr.ld_type >= QUANTIZE_U8)
+	{
+		GenQuantizedLoad(!!w, gqr.ld_type, gqr.ld_scale);
+	}
+	else
+	{
+		MOV(32, R(RSCRATCH2), Imm32(0x3F07));
 
-	AND(32, R(RSCRATCH2), gqr);
-	MOVZX(32, 8, RSCRATCH, R(RSCRATCH2));
+		// Get the high part of the GQR register
+		OpArg gqr_high = PPCSTATE(spr[SPR_GQR0 + i]);
+		gqr_high.AddMemOffset(2);
 
-	CALLptr(MScaled(RSCRATCH, SCALE_8, (u32)(u64)(&asm_routines.pairedLoadQuantized[w * 8])));
+		AND(32, R(RSCRATCH2), gqr_high);
+		MOVZX(32, 8, RSCRATCH, R(RSCRATCH2));
+
+		CALLptr(MScaled(RSCRATCH, SCALE_8, (u32)(u64)(&asm_routines.pairedLoadQuantized[w * 8])));
+	}
 
 	MemoryExceptionCheck();
 	CVTPS2PD(fpr.RX(s), R(XMM0));
@@ -324,3 +359,178 @@ void Jit64::psq_lXX(UGeckoInstruction inst)
 	gpr.UnlockAll();
 	gpr.UnlockAllX();
 }
+
+void Jit64::GenQuantizedLoad(bool single, EQuantizeType type, u32 scale)
+{
+	int size = (type == QUANTIZE_U8 || type == QUANTIZE_S8) ? 8 : 16;
+	bool sign_extend = type == QUANTIZE_S8 || type == QUANTIZE_S16;
+	if (!single)
+		size *= 2;
+
+	if (jo.memcheck)
+	{
+		SafeLoadToReg(RSCRATCH_EXTRA, R(RSCRATCH_EXTRA), size, 0, CallerSavedRegistersInUse(), single && sign_extend);
+		if (size == 16 && !single)
+			ROR(16, R(RSCRATCH_EXTRA), Imm8(8));
+	}
+	else if (type == QUANTIZE_U8 || type == QUANTIZE_S8)
+	{
+		UnsafeLoadRegToRegNoSwap(RSCRATCH_EXTRA, RSCRATCH_EXTRA, size, 0, single && sign_extend);
+	}
+	else
+	{
+		UnsafeLoadRegToReg(RSCRATCH_EXTRA, RSCRATCH_EXTRA, size, 0, single && sign_extend);
+	}
+
+	if (single)
+	{
+		CVTSI2SS(XMM0, R(RSCRATCH_EXTRA));
+		if (scale)
+			MULSS(XMM0, M(&m_dequantizeTableS[scale * 2]));
+		UNPCKLPS(XMM0, M(m_one));
+		return;
+	}
+
+	if (size == 32)
+		ROL(32, R(RSCRATCH_EXTRA), Imm8(16));
+	MOVD_xmm(XMM0, R(RSCRATCH_EXTRA));
+	switch (type)
+	{
+	case QUANTIZE_U8:
+		if (cpu_info.bSSE4_1)
+		{
+			PMOVZXBD(XMM0, R(XMM0));
+		}
+		else
+		{
+			PXOR(XMM1, R(XMM1));
+			PUNPCKLBW(XMM0, R(XMM1));
+			PUNPCKLWD(XMM0, R(XMM1));
+		}
+		break;
+	case QUANTIZE_S8:
+		if (cpu_info.bSSE4_1)
+		{
+			PMOVSXBD(XMM0, R(XMM0));
+		}
+		else
+		{
+			PUNPCKLBW(XMM0, R(XMM0));
+			PUNPCKLWD(XMM0, R(XMM0));
+			PSRAD(XMM0, 24);
+		}
+		break;
+	case QUANTIZE_U16:
+		if (cpu_info.bSSE4_1)
+		{
+			PMOVZXWD(XMM0, R(XMM0));
+		}
+		else
+		{
+			PXOR(XMM1, R(XMM1));
+			PUNPCKLWD(XMM0, R(XMM1));
+		}
+		break;
+	default:
+		if (cpu_info.bSSE4_1)
+		{
+			PMOVSXWD(XMM0, R(XMM0));
+		}
+		else
+		{
+			PUNPCKLWD(XMM0, R(XMM0));
+			PSRAD(XMM0, 16);
+		}
+		break;
+	}
+	CVTDQ2PS(XMM0, R(XMM0));
+	if (scale)
+	{
+		MOVQ_xmm(XMM1, M(&m_dequantizeTableS[scale * 2]));
+		MULPS(XMM0, R(XMM1));
+	}
+}
+
+void Jit64::GenQuantizedStore(bool single, EQuantizeType type, u32 scale)
+{
+	BitSet32 registersInUse = CallerSavedRegistersInUse();
+	int size = (type == QUANTIZE_U8 || type == QUANTIZE_S8) ? 8 : 16;
+
+	if (single)
+	{
+		if (scale)
+			MULSS(XMM0, M(&m_quantizeTableS[scale * 2]));
+		switch (type)
+		{
+		case QUANTIZE_U8:
+			XORPS(XMM1, R(XMM1));
+			MAXSS(XMM0, R(XMM1));
+			MINSS(XMM0, M(&m_255));
+			break;
+		case QUANTIZE_S8:
+			MAXSS(XMM0, M(&m_m128));
+			MINSS(XMM0, M(&m_127));
+			break;
+		case QUANTIZE_U16:
+			XORPS(XMM1, R(XMM1));
+			MAXSS(XMM0, R(XMM1));
+			MINSS(XMM0, M(m_65535));
+			break;
+		default:
+			MAXSS(XMM0, M(&m_m32768));
+			MINSS(XMM0, M(&m_32767));
+			break;
+		}
+		CVTTSS2SI(RSCRATCH, R(XMM0));
+		SafeWriteRegToReg(RSCRATCH, RSCRATCH_EXTRA, size, 0, registersInUse);
+		return;
+	}
+
+	if (scale)
+	{
+		MOVQ_xmm(XMM1, M(&m_quantizeTableS[scale * 2]));
+		MULPS(XMM0, R(XMM1));
+	}
+	if (type == QUANTIZE_U16 && !cpu_info.bSSE4_1)
+	{
+		XORPS(XMM1, R(XMM1));
+		MAXPS(XMM0, R(XMM1));
+		MINPS(XMM0, M(m_65535));
+
+		CVTTPS2DQ(XMM0, R(XMM0));
+		PSHUFLW(XMM0, R(XMM0), 2); // AABBCCDD -> CCAA____
+		MOVD_xmm(R(RSCRATCH), XMM0);
+		BSWAP(32, RSCRATCH);
+	}
+	else
+	{
+#ifdef QUANTIZE_OVERFLOW_SAFE
+		MINPS(XMM0, M(m_65535));
+#endif
+		CVTTPS2DQ(XMM0, R(XMM0));
+		switch (type)
+		{
+		case QUANTIZE_U8:
+			PACKSSDW(XMM0, R(XMM0));
+			PACKUSWB(XMM0, R(XMM0));
+			break;
+		case QUANTIZE_S8:
+			PACKSSDW(XMM0, R(XMM0));
+			PACKSSWB(XMM0, R(XMM0));
+			break;
+		case QUANTIZE_U16:
+			PACKUSDW(XMM0, R(XMM0));
+			break;
+		default:
+			PACKSSDW(XMM0, R(XMM0));
+			break;
+		}
+		MOVD_xmm(R(RSCRATCH), XMM0);
+		if (size == 16)
+		{
+			BSWAP(32, RSCRATCH);
+			ROL(32, R(RSCRATCH), Imm8(16));
+		}
+	}
+	SafeWriteRegToReg(RSCRATCH, RSCRATCH_EXTRA, size * 2, 0, registersInUse, SAFE_LOADSTORE_NO_SWAP);
+}
@@ -8,8 +8,10 @@
 //#define JIT_LOG_GPR     // Enables logging of the PPC general purpose regs
 //#define JIT_LOG_FPR     // Enables logging of the PPC floating point regs
 
+#include <unordered_map>
 #include <unordered_set>
 
+#include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "Core/ConfigManager.h"
@@ -57,6 +59,7 @@ protected:
 		bool fastmem;
 		bool memcheck;
 		bool alwaysUseMemFuncs;
+		bool hotTraces;
 	};
 	struct JitState
 	{
@@ -79,6 +82,9 @@ protected:
 		int revertFprLoad;
 
 		bool assumeNoPairedQuantize;
+		// GQRs the block was compiled for the values of, checked on block entry.
+		BitSet8 constantGqr;
+		u32 constantGqrValue[8];
 		bool firstFPInstructionFound;
 		bool isLastInstruction;
 		int skipInstructions;
@@ -95,8 +101,17 @@ protected:
 
 		JitBlock *curBlock;
 
+		// Set while compiling a hot trace rather than a profiled block.
+		bool hotTrace;
+
 		std::unordered_set<u32> fifoWriteAddresses;
 		std::unordered_set<u32> pairedQuantizeAddresses;
+		// Block start addresses which got hot enough to be compiled as traces.
+		std::unordered_set<u32> hotTraceAddresses;
+		// Counters for the conditional branches of profiled blocks, keyed by branch address.
+		// The generated code increments them, so elements must never move and the map
+		// may only be cleared together with the code space.
+		std::unordered_map<u32, PPCAnalyst::BranchProfile> branchProfile;
 	};
 
 	PPCAnalyst::CodeBlock code_block;
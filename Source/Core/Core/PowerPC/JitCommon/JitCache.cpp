@@ -19,6 +19,8 @@
 #include "Core/Core.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 #ifdef _WIN32
@@ -52,6 +54,7 @@ using namespace Gen;
 
 	void JitBaseBlockCache::Shutdown()
 	{
+		SamplingProfiler::FlushSamples(*this);
 		num_blocks = 0;
 		m_initialized = false;
 
@@ -68,14 +71,18 @@ using namespace Gen;
 		else
 			Core::DisplayMessage("Clearing code cache.", 3000);
 #endif
+		// Samples can only be mapped to blocks while their code is still around.
+		SamplingProfiler::FlushSamples(*this);
 		jit->js.fifoWriteAddresses.clear();
 		jit->js.pairedQuantizeAddresses.clear();
+		jit->js.hotTraceAddresses.clear();
 		for (int i = 0; i < num_blocks; i++)
 		{
 			DestroyBlock(i, false);
 		}
 		links_to.clear();
 		block_map.clear();
+		trace_map.clear();
 
 		valid_block.ClearAll();
 
@@ -105,6 +112,7 @@ using namespace Gen;
 		b.invalid = false;
 		b.originalAddress = em_address;
 		b.linkData.clear();
+		b.codeRanges.clear();
 		num_blocks++; //commit the current block
 		return num_blocks - 1;
 	}
@@ -116,13 +124,17 @@ using namespace Gen;
 
 		std::memcpy(GetICachePtr(b.originalAddress), &block_num, sizeof(u32));
 
-		// Convert the logical address to a physical address for the block map
-		u32 pAddr = b.originalAddress & 0x1FFFFFFF;
-
-		for (u32 block = pAddr / 32; block <= (pAddr + (b.originalSize - 1) * 4) / 32; ++block)
-			valid_block.Set(block);
-
-		block_map[std::make_pair(pAddr + 4 * b.originalSize - 1, pAddr)] = block_num;
+		if (b.codeRanges.empty())
+		{
+			AddToBlockMap(block_num, b.originalAddress, b.originalSize, false);
+		}
+		else
+		{
+			// Traces are registered once per run of code so that writing to any part
+			// of them destroys the whole block.
+			for (const auto& range : b.codeRanges)
+				AddToBlockMap(block_num, range.first, range.second, true);
+		}
 
 		if (block_link)
 		{
@@ -135,8 +147,28 @@ using namespace Gen;
 			LinkBlockExits(block_num);
 		}
 
-		JitRegister::Register(blockCodePointers[block_num], b.codeSize,
-			"JIT_PPC_%08x", b.originalAddress);
+		if (JitRegister::IsEnabled())
+		{
+			// Name blocks after their function so profilers can group them.
+			Symbol* symbol = g_symbolDB.GetSymbolFromAddr(b.originalAddress);
+			if (symbol)
+				JitRegister::Register(blockCodePointers[block_num], b.codeSize,
+					"JIT_PPC_%08x_%s", b.originalAddress, symbol->name.c_str());
+			else
+				JitRegister::Register(blockCodePointers[block_num], b.codeSize,
+					"JIT_PPC_%08x", b.originalAddress);
+		}
+	}
+
+	void JitBaseBlockCache::AddToBlockMap(int block_num, u32 address, u32 size, bool trace)
+	{
+		// Convert the logical address to a physical address for the block map
+		u32 pAddr = address & 0x1FFFFFFF;
+
+		for (u32 block = pAddr / 32; block <= (pAddr + (size - 1) * 4) / 32; ++block)
+			valid_block.Set(block);
+
+		(trace ? trace_map : block_map)[std::make_pair(pAddr + 4 * size - 1, pAddr)] = block_num;
 	}
 
 	const u8 **JitBaseBlockCache::GetCodePointers()
@@ -301,6 +333,21 @@ using namespace Gen;
 				block_map.erase(it1, it2);
 			}
 
+			// Trace runs don't hold to that, so every one ending at or after the address is checked.
+			// A trace has one entry per run of code, the block may already be gone.
+			auto trace = trace_map.lower_bound(std::make_pair(pAddr, 0));
+			while (trace != trace_map.end())
+			{
+				if (trace->first.second >= pAddr + length)
+				{
+					++trace;
+					continue;
+				}
+				if (!blocks[trace->second].invalid)
+					DestroyBlock(trace->second, true);
+				trace = trace_map.erase(trace);
+			}
+
 			// If the code was actually modified, we need to clear the relevant entries from the
 			// FIFO write address cache, so we don't end up with FIFO checks in places they shouldn't
 			// be (this can clobber flags, and thus break any optimization that relies on flags
@@ -311,6 +358,7 @@ using namespace Gen;
 				{
 					jit->js.fifoWriteAddresses.erase(i);
 					jit->js.pairedQuantizeAddresses.erase(i);
+					jit->js.hotTraceAddresses.erase(i);
 				}
 			}
 		}
@@ -8,6 +8,7 @@
 #include <bitset>
 #include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -32,9 +33,15 @@ struct JitBlock
 	u32 codeSize;
 	u32 originalSize;
 	int runCount;  // for profiling.
+	// Entries left until the block is recompiled as a hot trace.
+	u32 hotCountdown;
 
 	bool invalid;
 
+	// (start address, number of instructions) of every run of guest code a trace
+	// was built from. Empty for blocks made of a single run.
+	std::vector<std::pair<u32, u32>> codeRanges;
+
 	struct LinkData
 	{
 		u8 *exitPtrs;    // to be able to rewrite the exit jum
@@ -104,6 +111,8 @@ class JitBaseBlockCache
 	int num_blocks;
 	std::multimap<u32, int> links_to;
 	std::map<std::pair<u32, u32>, u32> block_map; // (end_addr, start_addr) -> number
+	// The same for the runs of code of hot traces, which can end in the middle of other blocks
+	std::map<std::pair<u32, u32>, u32> trace_map;
 	ValidBlockBitSet valid_block;
 
 	bool m_initialized;
@@ -113,6 +122,7 @@ class JitBaseBlockCache
 	void UnlinkBlock(int i);
 
 	u8* GetICachePtr(u32 addr);
+	void AddToBlockMap(int block_num, u32 address, u32 size, bool trace);
 	void DestroyBlock(int block_num, bool invalidate);
 
 	// Virtual for overloaded
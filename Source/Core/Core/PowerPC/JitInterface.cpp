@@ -282,6 +282,17 @@ namespace JitInterface
 		}
 	}
 
+	void CompileHotTrace()
+	{
+		if (!jit || PC == 0)
+			return;
+
+		jit->js.hotTraceAddresses.insert(PC);
+
+		// The dispatcher finds no block at PC anymore and compiles the trace.
+		jit->GetBlockCache()->InvalidateICache(PC, 4, true);
+	}
+
 	void Shutdown()
 	{
 		if (jit)
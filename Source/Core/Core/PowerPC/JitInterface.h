@@ -43,5 +43,8 @@ namespace JitInterface
 
 	void CompileExceptionCheck(ExceptionType type);
 
+	// Called by profiled blocks once they got hot: recompile the block at PC as a trace.
+	void CompileHotTrace();
+
 	void Shutdown();
 }
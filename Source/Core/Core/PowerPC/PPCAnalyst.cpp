@@ -32,6 +32,11 @@ namespace PPCAnalyst
 static const int CODEBUFFER_SIZE = 32000;
 // 0 does not perform block merging
 static const u32 FUNCTION_FOLLOWING_THRESHOLD = 16;
+// Branches a hot trace may follow before it has to end.
+static const u32 TRACE_FOLLOWING_THRESHOLD = 8;
+// A conditional branch needs this many samples and to be taken at least two thirds
+// of the time before a trace continues at its target.
+static const u32 HOT_BRANCH_MIN_SAMPLES = 16;
 
 CodeBuffer::CodeBuffer(int size)
 {
@@ -621,6 +626,50 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInf
 	}
 }
 
+bool PPCAnalyzer::IsHotBranch(u32 address) const
+{
+	if (!m_branch_profile)
+		return false;
+	auto it = m_branch_profile->find(address);
+	if (it == m_branch_profile->end())
+		return false;
+	const BranchProfile& profile = it->second;
+	return profile.taken + profile.notTaken >= HOT_BRANCH_MIN_SAMPLES &&
+	       profile.taken >= 2 * profile.notTaken;
+}
+
+int PPCAnalyzer::FindIdleLoopBranch(u32 start, const CodeOp *code, u32 instructions) const
+{
+	// A polling loop runs from the start of the block to a branch back there, with nothing
+	// but integer instructions and loads in between. Every register it writes must be written
+	// before it is read, so no iteration depends on the one before it; the loop can only end
+	// when something outside of it (an interrupt, another thread, hardware) changes memory.
+	BitSet32 carried_regs, written_regs;
+	for (u32 i = 0; i < instructions; i++)
+	{
+		const CodeOp& op = code[i];
+		if (op.opinfo->type == OPTYPE_BRANCH)
+		{
+			const UGeckoInstruction inst = op.inst;
+			if (inst.OPCD != 16 || inst.LK || !(inst.BO & BO_DONT_DECREMENT_FLAG))
+				return -1;
+			u32 destination = inst.AA ? SignExt16(inst.BD << 2) : op.address + SignExt16(inst.BD << 2);
+			return destination == start ? i : -1;
+		}
+
+		if (op.opinfo->type != OPTYPE_INTEGER && op.opinfo->type != OPTYPE_LOAD)
+			return -1;
+		if (op.opinfo->flags & FL_READ_CA)
+			return -1;
+
+		carried_regs |= op.regsIn & ~written_regs;
+		if (op.regsOut & carried_regs)
+			return -1;
+		written_regs |= op.regsOut;
+	}
+	return -1;
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32 blockSize)
 {
 	// Clear block stats
@@ -641,6 +690,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 	block->m_memory_exception = false;
 	block->m_num_instructions = 0;
 	block->m_gqr_used = BitSet8(0);
+	block->m_ranges.clear();
 
 	CodeOp *code = buffer->codebuffer;
 
@@ -649,6 +699,21 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 	u32 numFollows = 0;
 	u32 num_inst = 0;
 	bool prev_inst_from_bat = true;
+	u32 range_start = address;
+	u32 range_size = 0;
+
+	// Traces only continue at code they have not covered yet; loops end them.
+	auto in_block = [&](u32 target)
+	{
+		if (target >= range_start && target - range_start < range_size * 4)
+			return true;
+		for (const auto& range : block->m_ranges)
+		{
+			if (target >= range.first && target - range.first < range.second * 4)
+				return true;
+		}
+		return false;
+	};
 
 	for (u32 i = 0; i < blockSize; ++i)
 	{
@@ -672,6 +737,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 		prev_inst_from_bat = result.from_bat;
 
 		num_inst++;
+		range_size++;
 		memset(&code[i], 0, sizeof(CodeOp));
 		GekkoOPInfo *opinfo = GetOpInfo(inst);
 
@@ -766,6 +832,46 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 			}
 		}
 
+		if (HasOption(OPTION_HOT_TRACE) && result.from_bat && numFollows < TRACE_FOLLOWING_THRESHOLD)
+		{
+			bool followed_call = false;
+			if (inst.OPCD == 18 && (!inst.LK || return_address == 0))
+			{
+				// bx; calls are followed one level deep so that the return can be followed too.
+				destination = EvaluateBranchTarget(inst, address);
+				follow = !in_block(destination);
+				followed_call = follow && inst.LK;
+				if (followed_call)
+					return_address = address + 4;
+			}
+			else if (inst.OPCD == 16 && !inst.LK && conditional_continue && IsHotBranch(address))
+			{
+				destination = inst.AA ? SignExt16(inst.BD << 2) : address + SignExt16(inst.BD << 2);
+				follow = !in_block(destination);
+				code[i].branchIsFollowed = follow;
+			}
+			else if (inst.hex == 0x4e800020 && return_address != 0)
+			{
+				// blr from a followed call. Nothing wrote LR since the call set it,
+				// so the return address is known and the blr itself has no effect.
+				destination = return_address;
+				follow = !in_block(destination);
+				code[i].skip = follow;
+				return_address = 0;
+			}
+			else if (inst.OPCD == 31 && inst.SUBOP10 == 467 && ((inst.SPRU << 5) | (inst.SPRL & 0x1F)) == SPR_LR)
+			{
+				// mtlr: the return can no longer be followed.
+				return_address = 0;
+			}
+
+			// Every other branch with LK set writes LR, bcl even when it isn't taken.
+			const bool is_branch = inst.OPCD == 16 || inst.OPCD == 18 ||
+			                       (inst.OPCD == 19 && (inst.SUBOP10 == 16 || inst.SUBOP10 == 528));
+			if (is_branch && inst.LK && !followed_call)
+				return_address = 0;
+		}
+
 		if (!follow)
 		{
 			address += 4;
@@ -775,22 +881,28 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 				break;
 			}
 		}
-		// XXX: We don't support inlining yet.
-#if 0
 		else
 		{
 			numFollows++;
 			// We don't "code[i].skip = true" here
 			// because bx may store a certain value to the link register.
 			// Instead, we skip a part of bx in Jit**::bx().
+			block->m_ranges.emplace_back(range_start, range_size);
 			address = destination;
-			merged_addresses[size_of_merged_addresses++] = address;
+			range_start = address;
+			range_size = 0;
 		}
-#endif
 	}
 
+	if (range_size > 0)
+		block->m_ranges.emplace_back(range_start, range_size);
+
 	block->m_num_instructions = num_inst;
 
+	int idle_branch = FindIdleLoopBranch(block->m_address, code, num_inst);
+	if (idle_branch >= 0)
+		code[idle_branch].branchIsIdleLoop = true;
+
 	if (block->m_num_instructions > 1)
 		ReorderInstructions(block->m_num_instructions, code);
 
@@ -8,6 +8,8 @@
 #include <cstdlib>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Common/BitSet.h"
@@ -43,6 +45,8 @@ struct CodeOp //16B
 	bool outputCA;
 	bool canEndBlock;
 	bool skip;  // followed BL-s for example
+	bool branchIsFollowed;  // conditional branch whose target the block continues at
+	bool branchIsIdleLoop;  // branch back to the block start closing a loop that only polls
 	// which registers are still needed after this instruction in this block
 	BitSet32 fprInUse;
 	BitSet32 gprInUse;
@@ -60,6 +64,13 @@ struct CodeOp //16B
 	BitSet32 fprIsStoreSafe;
 };
 
+// How often a conditional branch went each way, gathered by the JIT for hot traces.
+struct BranchProfile
+{
+	u32 taken;
+	u32 notTaken;
+};
+
 struct BlockStats
 {
 	bool isFirstBlockOfFunction;
@@ -164,6 +175,10 @@ struct CodeBlock
 
 	// Which GQRs this block modifies, if any.
 	BitSet8 m_gqr_modified;
+
+	// The contiguous runs of guest code the block was built from, as
+	// (start address, number of instructions). Only traces have more than one.
+	std::vector<std::pair<u32, u32>> m_ranges;
 };
 
 class PPCAnalyzer
@@ -181,8 +196,12 @@ private:
 	void ReorderInstructions(u32 instructions, CodeOp *code);
 	void SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInfo *opinfo, u32 index);
 
+	bool IsHotBranch(u32 address) const;
+	int FindIdleLoopBranch(u32 start, const CodeOp *code, u32 instructions) const;
+
 	// Options
 	u32 m_options;
+	const std::unordered_map<u32, BranchProfile>* m_branch_profile;
 public:
 
 	enum AnalystOption
@@ -221,16 +240,24 @@ public:
 
 		// Reorder cror instructions next to their associated fcmp.
 		OPTION_CROR_MERGE =  (1 << 6),
+
+		// Build a trace along the hot path instead of stopping at the first branch.
+		// Direct branches and calls to leaf functions are followed, as are conditional
+		// branches which the branch profile says are usually taken.
+		// Requires OPTION_CONDITIONAL_CONTINUE and JIT support for followed branches.
+		OPTION_HOT_TRACE = (1 << 7),
 	};
 
 
-	PPCAnalyzer() : m_options(0) {}
+	PPCAnalyzer() : m_options(0), m_branch_profile(nullptr) {}
 
 	// Option setting/getting
 	void SetOption(AnalystOption option) { m_options |= option; }
 	void ClearOption(AnalystOption option) { m_options &= ~(option); }
 	bool HasOption(AnalystOption option) const { return !!(m_options & option); }
 
+	void SetBranchProfile(const std::unordered_map<u32, BranchProfile>* profile) { m_branch_profile = profile; }
+
 	u32 Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32 blockSize);
 };
 
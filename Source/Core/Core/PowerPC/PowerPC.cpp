@@ -28,7 +28,9 @@ namespace PowerPC
 
 // STATE_TO_SAVE
 PowerPCState ppcState;
-static volatile CPUState state = CPU_POWERDOWN;
+static std::atomic<CPUState> state{CPU_POWERDOWN};
+// The JITs test the state with 32-bit loads
+static_assert(sizeof(state) == sizeof(u32), "CPUState must be 32 bits");
 
 Interpreter * const interpreter = Interpreter::getInstance();
 static CoreMode mode;
@@ -215,7 +217,8 @@ void SingleStep()
 
 void RunLoop()
 {
-	state = CPU_RUNNING;
+	// CPU::Run only gets here while running. Setting the state again would undo a Pause or
+	// Stop from another thread that came in the meantime.
 	cpu_core_base->Run();
 	Host_UpdateDisasmDialog();
 }
@@ -225,7 +228,7 @@ CPUState GetState()
 	return state;
 }
 
-volatile CPUState *GetStatePtr()
+std::atomic<CPUState> *GetStatePtr()
 {
 	return &state;
 }
@@ -236,26 +239,28 @@ void Start()
 	Host_UpdateDisasmDialog();
 }
 
-void Pause()
+// Moves the CPU out of the running states, and waits for the CPU thread to notice
+static void LeaveRunning(CPUState new_state)
 {
-	volatile CPUState old_state = state;
-	state = CPU_STEPPING;
+	// Only a FinishStateMove after the state change counts, the previous run loop exit
+	// (e.g. for a safe point) also set the event.
+	s_state_change.Reset();
+	CPUState old_state = state.exchange(new_state);
 
-	// Wait for the CPU core to leave
-	if (old_state == CPU_RUNNING)
+	// Wait for the CPU core to leave, or to finish its safe point callback
+	if (old_state == CPU_RUNNING || old_state == CPU_SAFE_POINT)
 		s_state_change.WaitFor(std::chrono::seconds(1));
 	Host_UpdateDisasmDialog();
 }
 
-void Stop()
+void Pause()
 {
-	volatile CPUState old_state = state;
-	state = CPU_POWERDOWN;
+	LeaveRunning(CPU_STEPPING);
+}
 
-	// Wait for the CPU core to leave
-	if (old_state == CPU_RUNNING)
-		s_state_change.WaitFor(std::chrono::seconds(1));
-	Host_UpdateDisasmDialog();
+void Stop()
+{
+	LeaveRunning(CPU_POWERDOWN);
 }
 
 void FinishStateMove()
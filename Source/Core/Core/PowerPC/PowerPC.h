@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <tuple>
 
@@ -132,6 +133,8 @@ static_assert(offsetof(PowerPC::PowerPCState, above_fits_in_first_0x100) <= 0x10
 enum CPUState
 {
 	CPU_RUNNING = 0,
+	// Leave the run loop once to run CPU::RequestSafePoint's callback, then carry on.
+	CPU_SAFE_POINT = 1,
 	CPU_STEPPING = 2,
 	CPU_POWERDOWN = 3,
 };
@@ -160,7 +163,7 @@ void Pause();
 void Stop();
 void FinishStateMove();
 CPUState GetState();
-volatile CPUState *GetStatePtr();  // this oddity is here instead of an extern declaration to easily be able to find all direct accesses throughout the code.
+std::atomic<CPUState> *GetStatePtr();  // this oddity is here instead of an extern declaration to easily be able to find all direct accesses throughout the code.
 
 u32 CompactCR();
 void ExpandCR(u32 cr);
@@ -0,0 +1,253 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Flag.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Common/Logging/Log.h"
+#include "Core/MachineContext.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/SamplingProfiler.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+namespace SamplingProfiler
+{
+
+// Host PCs are written by whoever takes the sample (the CPU thread's signal handler, or the
+// sampler thread on Windows) and read by FlushSamples, so this is a single producer, single
+// consumer ring. Samples are dropped rather than overwritten if it fills up.
+static const u32 SAMPLE_BUFFER_SIZE = 1 << 16;
+static std::array<u64, SAMPLE_BUFFER_SIZE> s_samples;
+static std::atomic<u32> s_sample_write{0};
+static std::atomic<u32> s_sample_read{0};
+static std::atomic<u32> s_dropped_samples{0};
+
+// Samples mapped to blocks, keyed by the guest address of the block.
+static std::mutex s_results_lock;
+static std::map<u32, u64> s_block_samples;
+static u64 s_other_samples;
+
+static Common::Flag s_running;
+static std::thread s_sampler_thread;
+
+static std::mutex s_cpu_thread_lock;
+static bool s_cpu_thread_valid = false;
+#ifdef _WIN32
+static HANDLE s_cpu_thread;
+#else
+static pthread_t s_cpu_thread;
+#endif
+
+static void RecordSample(u64 pc)
+{
+	u32 write = s_sample_write.load(std::memory_order_relaxed);
+	if (write - s_sample_read.load(std::memory_order_acquire) >= SAMPLE_BUFFER_SIZE)
+	{
+		s_dropped_samples.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	s_samples[write % SAMPLE_BUFFER_SIZE] = pc;
+	s_sample_write.store(write + 1, std::memory_order_release);
+}
+
+#if !defined(_WIN32) && !defined(_M_GENERIC)
+static void SigprofHandler(int sig, siginfo_t* info, void* raw_context)
+{
+	ucontext_t* context = (ucontext_t*)raw_context;
+#if defined(__APPLE__)
+	RecordSample(context->uc_mcontext->__ss.__rip);
+#elif defined(_M_X86_64)
+	RecordSample(context->uc_mcontext.CTX_RIP);
+#else
+	RecordSample(context->uc_mcontext.CTX_PC);
+#endif
+}
+#endif
+
+static void SamplerThread(u32 frequency)
+{
+	Common::SetCurrentThreadName("Sampling profiler");
+
+	const auto period = std::chrono::microseconds(1000000 / frequency);
+	while (s_running.IsSet())
+	{
+		std::this_thread::sleep_for(period);
+
+		// Held while sampling so that the CPU thread cannot go away in the middle of it.
+		std::lock_guard<std::mutex> lk(s_cpu_thread_lock);
+		if (!s_cpu_thread_valid)
+			continue;
+#ifdef _WIN32
+		if (SuspendThread(s_cpu_thread) == (DWORD)-1)
+			continue;
+		CONTEXT context;
+		context.ContextFlags = CONTEXT_CONTROL;
+		if (GetThreadContext(s_cpu_thread, &context))
+			RecordSample(context.CTX_RIP);
+		ResumeThread(s_cpu_thread);
+#else
+		pthread_kill(s_cpu_thread, SIGPROF);
+#endif
+	}
+}
+
+void RegisterCPUThread()
+{
+	std::lock_guard<std::mutex> lk(s_cpu_thread_lock);
+#ifdef _WIN32
+	s_cpu_thread_valid = !!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(),
+		&s_cpu_thread, THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, 0);
+#else
+	s_cpu_thread = pthread_self();
+	s_cpu_thread_valid = true;
+#endif
+}
+
+void UnregisterCPUThread()
+{
+	std::lock_guard<std::mutex> lk(s_cpu_thread_lock);
+#ifdef _WIN32
+	if (s_cpu_thread_valid)
+		CloseHandle(s_cpu_thread);
+#endif
+	s_cpu_thread_valid = false;
+}
+
+bool Start(u32 frequency)
+{
+#if defined(_M_GENERIC)
+	return false;
+#else
+	if (s_running.IsSet())
+		return true;
+
+	{
+		std::lock_guard<std::mutex> lk(s_results_lock);
+		s_block_samples.clear();
+		s_other_samples = 0;
+		s_dropped_samples = 0;
+		s_sample_read.store(s_sample_write.load());
+	}
+
+#ifndef _WIN32
+	// The handler stays installed after Stop(), a signal may still be pending then.
+	struct sigaction sa;
+	sa.sa_sigaction = &SigprofHandler;
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, nullptr);
+#endif
+
+	s_running.Set();
+	s_sampler_thread = std::thread(SamplerThread, std::max(frequency, 1u));
+	return true;
+#endif
+}
+
+void Stop()
+{
+	if (!s_running.TestAndClear())
+		return;
+	s_sampler_thread.join();
+}
+
+bool IsRunning()
+{
+	return s_running.IsSet();
+}
+
+void FlushSamples(JitBaseBlockCache& blocks)
+{
+	u32 write = s_sample_write.load(std::memory_order_acquire);
+	u32 read = s_sample_read.load(std::memory_order_relaxed);
+	if (read == write)
+		return;
+
+	// Blocks are only destroyed when the whole cache is cleared, and code space is never
+	// reused before that, so the host code of the blocks does not overlap.
+	struct HostRange
+	{
+		const u8* start;
+		const u8* end;
+		u32 address;
+	};
+	std::vector<HostRange> ranges;
+	ranges.reserve(blocks.GetNumBlocks());
+	for (int i = 0; i < blocks.GetNumBlocks(); i++)
+	{
+		const JitBlock* b = blocks.GetBlock(i);
+		if (b->checkedEntry)
+			ranges.push_back({b->checkedEntry, b->checkedEntry + b->codeSize, b->originalAddress});
+	}
+	std::sort(ranges.begin(), ranges.end(), [](const HostRange& a, const HostRange& b)
+	{
+		return a.start < b.start;
+	});
+
+	std::lock_guard<std::mutex> lk(s_results_lock);
+	for (; read != write; read++)
+	{
+		const u8* pc = reinterpret_cast<const u8*>(s_samples[read % SAMPLE_BUFFER_SIZE]);
+		auto it = std::upper_bound(ranges.begin(), ranges.end(), pc, [](const u8* p, const HostRange& range)
+		{
+			return p < range.start;
+		});
+		if (it != ranges.begin() && pc < (--it)->end)
+			s_block_samples[it->address]++;
+		else
+			s_other_samples++;
+	}
+	s_sample_read.store(read, std::memory_order_release);
+}
+
+bool WriteReport(const std::string& filename)
+{
+	if (jit)
+		FlushSamples(*jit->GetBlockCache());
+
+	File::IOFile f(filename, "w");
+	if (!f)
+		return false;
+
+	std::lock_guard<std::mutex> lk(s_results_lock);
+	u64 total = s_other_samples;
+	for (const auto& it : s_block_samples)
+	{
+		Symbol* symbol = g_symbolDB.GetSymbolFromAddr(it.first);
+		std::string line = StringFromFormat("%s;JIT_PPC_%08x %" PRIu64 "\n",
+			symbol ? symbol->name.c_str() : "unknown", it.first, it.second);
+		f.WriteBytes(line.data(), line.size());
+		total += it.second;
+	}
+	// Dispatcher, far code and everything outside of JIT code: the CPU thread in C++.
+	if (s_other_samples)
+	{
+		std::string line = StringFromFormat("[not in a block] %" PRIu64 "\n", s_other_samples);
+		f.WriteBytes(line.data(), line.size());
+	}
+
+	INFO_LOG(POWERPC, "Wrote %" PRIu64 " samples to %s (%u dropped)", total, filename.c_str(),
+	         s_dropped_samples.load());
+	return true;
+}
+
+}  // namespace
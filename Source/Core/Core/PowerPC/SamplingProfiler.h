@@ -0,0 +1,36 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+class JitBaseBlockCache;
+
+// Statistical profiler for JIT code. A sampler thread interrupts the CPU thread at a fixed
+// rate and records the host PC it was at; the samples are later mapped back to the JIT blocks
+// and guest functions they landed in. Unlike block profiling, the generated code is unchanged.
+namespace SamplingProfiler
+{
+
+// Called on the CPU thread when it starts and stops running guest code.
+void RegisterCPUThread();
+void UnregisterCPUThread();
+
+bool Start(u32 frequency = 1000);
+// Does nothing when not running. Core stops the profiler along with the emulation.
+void Stop();
+bool IsRunning();
+
+// Maps the pending samples to blocks. Must run before the block cache throws its code away,
+// either on the CPU thread or while it does not run JIT code.
+void FlushSamples(JitBaseBlockCache& blocks);
+
+// Writes the samples in the folded stack format of flamegraph.pl ("function;block count").
+// The core must be paused.
+bool WriteReport(const std::string& filename);
+
+}  // namespace
@@ -208,6 +208,11 @@ void LoadFromBuffer(std::vector<u8>& buffer)
 		return;
 	}
 
+	LoadFromBufferForRollback(buffer);
+}
+
+void LoadFromBufferForRollback(std::vector<u8>& buffer)
+{
 	bool wasUnpaused = Core::PauseAndLock(true);
 
 	u8* ptr = &buffer[0];
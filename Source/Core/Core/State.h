@@ -52,6 +52,8 @@ void VerifyAt(const std::string &filename);
 
 void SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
+// Rollback netplay keeps the players in sync itself, so it may load states while netplay runs.
+void LoadFromBufferForRollback(std::vector<u8>& buffer);
 void VerifyBuffer(std::vector<u8>& buffer);
 
 void LoadLastSaved(int i = 1);
@@ -2,19 +2,27 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 #include <mbedtls/aes.h>
 #include <mbedtls/sha1.h>
 
+#include "Common/Assert.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
 #include "Common/MsgHandler.h"
+#include "Common/ThreadPool.h"
 #include "Common/Logging/Log.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/FileMonitor.h"
@@ -27,6 +35,172 @@
 namespace DiscIO
 {
 
+// Clusters of a batched read are decrypted in parallel when there are at least this many
+static const u64 PARALLEL_CLUSTERS = 4;
+// Bounds the raw data Read buffers at a time, 2 MiB
+static const u64 MAX_BATCH_CLUSTERS = 64;
+
+#ifdef _M_X86
+FUNCTION_TARGET_AES
+static __m128i ExpandKeyStep(__m128i key, __m128i assist)
+{
+	assist = _mm_shuffle_epi32(assist, 0xff);
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	return _mm_xor_si128(key, assist);
+}
+
+// AESDEC uses the round keys of the equivalent inverse cipher, in reverse order
+FUNCTION_TARGET_AES
+static void ExpandDecryptionKeyAESNI(const u8* key, u8* round_keys)
+{
+	__m128i enc[11];
+	enc[0] = _mm_loadu_si128((const __m128i*)key);
+	enc[1] = ExpandKeyStep(enc[0], _mm_aeskeygenassist_si128(enc[0], 0x01));
+	enc[2] = ExpandKeyStep(enc[1], _mm_aeskeygenassist_si128(enc[1], 0x02));
+	enc[3] = ExpandKeyStep(enc[2], _mm_aeskeygenassist_si128(enc[2], 0x04));
+	enc[4] = ExpandKeyStep(enc[3], _mm_aeskeygenassist_si128(enc[3], 0x08));
+	enc[5] = ExpandKeyStep(enc[4], _mm_aeskeygenassist_si128(enc[4], 0x10));
+	enc[6] = ExpandKeyStep(enc[5], _mm_aeskeygenassist_si128(enc[5], 0x20));
+	enc[7] = ExpandKeyStep(enc[6], _mm_aeskeygenassist_si128(enc[6], 0x40));
+	enc[8] = ExpandKeyStep(enc[7], _mm_aeskeygenassist_si128(enc[7], 0x80));
+	enc[9] = ExpandKeyStep(enc[8], _mm_aeskeygenassist_si128(enc[8], 0x1b));
+	enc[10] = ExpandKeyStep(enc[9], _mm_aeskeygenassist_si128(enc[9], 0x36));
+
+	__m128i* dec = (__m128i*)round_keys;
+	_mm_storeu_si128(dec, enc[10]);
+	for (int i = 1; i < 10; i++)
+		_mm_storeu_si128(dec + i, _mm_aesimc_si128(enc[10 - i]));
+	_mm_storeu_si128(dec + 10, enc[0]);
+}
+
+// Unlike encryption, CBC decryption doesn't depend on the previous block's result, so four
+// blocks are in flight at a time to hide the latency of AESDEC. size must be a multiple of 64.
+FUNCTION_TARGET_AES
+static void DecryptCBCAESNI(const u8* round_keys, const u8* iv, const u8* in, u8* out, size_t size)
+{
+	_assert_msg_(DISCIO, size % 64 == 0, "AES-NI decryption of %zu bytes", size);
+
+	__m128i keys[11];
+	for (int i = 0; i < 11; i++)
+		keys[i] = _mm_loadu_si128((const __m128i*)round_keys + i);
+
+	const __m128i* src = (const __m128i*)in;
+	__m128i* dst = (__m128i*)out;
+	const size_t blocks = size / 16;
+	__m128i prev = _mm_loadu_si128((const __m128i*)iv);
+	for (size_t i = 0; i < blocks; i += 4)
+	{
+		__m128i c0 = _mm_loadu_si128(src + i);
+		__m128i c1 = _mm_loadu_si128(src + i + 1);
+		__m128i c2 = _mm_loadu_si128(src + i + 2);
+		__m128i c3 = _mm_loadu_si128(src + i + 3);
+		__m128i x0 = _mm_xor_si128(c0, keys[0]);
+		__m128i x1 = _mm_xor_si128(c1, keys[0]);
+		__m128i x2 = _mm_xor_si128(c2, keys[0]);
+		__m128i x3 = _mm_xor_si128(c3, keys[0]);
+		for (int r = 1; r < 10; r++)
+		{
+			x0 = _mm_aesdec_si128(x0, keys[r]);
+			x1 = _mm_aesdec_si128(x1, keys[r]);
+			x2 = _mm_aesdec_si128(x2, keys[r]);
+			x3 = _mm_aesdec_si128(x3, keys[r]);
+		}
+		x0 = _mm_aesdeclast_si128(x0, keys[10]);
+		x1 = _mm_aesdeclast_si128(x1, keys[10]);
+		x2 = _mm_aesdeclast_si128(x2, keys[10]);
+		x3 = _mm_aesdeclast_si128(x3, keys[10]);
+		_mm_storeu_si128(dst + i, _mm_xor_si128(x0, prev));
+		_mm_storeu_si128(dst + i + 1, _mm_xor_si128(x1, c0));
+		_mm_storeu_si128(dst + i + 2, _mm_xor_si128(x2, c1));
+		_mm_storeu_si128(dst + i + 3, _mm_xor_si128(x3, c2));
+		prev = c3;
+	}
+}
+#endif
+
+// Runs the decryption of the clusters of a batched read on the shared thread pool. The
+// reading thread takes clusters as well, so it never waits for an idle worker to wake up.
+// Only one read at a time gets help, concurrent ones decrypt on their own thread.
+class ClusterDecryptWorker final : public Common::IWorker
+{
+public:
+	static ClusterDecryptWorker& GetInstance()
+	{
+		static ClusterDecryptWorker instance;
+		return instance;
+	}
+
+	void Run(u64 count, const std::function<void(u64)>& decrypt)
+	{
+		Job job;
+		job.decrypt = &decrypt;
+		job.count = count;
+
+		std::unique_lock<std::mutex> lk(m_run_lock, std::try_to_lock);
+		if (lk.owns_lock())
+		{
+			m_job.store(&job);
+			for (u64 i = 1; i < count; i++)
+				Common::ThreadPool::NotifyWorkPending();
+		}
+
+		while (DecryptNext(job))
+		{
+		}
+
+		if (lk.owns_lock())
+		{
+			// Workers may still be busy with the last clusters
+			m_job.store(nullptr);
+			u32 loopcount = 0;
+			while (m_active.load() > 0)
+				Common::cYield(loopcount++);
+		}
+	}
+
+	bool NextTask() override
+	{
+		m_active.fetch_add(1);
+		Job* job = m_job.load();
+		bool worked = job && DecryptNext(*job);
+		m_active.fetch_sub(1);
+		return worked;
+	}
+
+private:
+	struct Job
+	{
+		const std::function<void(u64)>* decrypt;
+		u64 count;
+		std::atomic<u64> next{0};
+	};
+
+	ClusterDecryptWorker()
+	{
+		Common::ThreadPool::RegisterWorker(this);
+	}
+
+	~ClusterDecryptWorker()
+	{
+		Common::ThreadPool::UnregisterWorker(this);
+	}
+
+	static bool DecryptNext(Job& job)
+	{
+		u64 index = job.next.fetch_add(1);
+		if (index >= job.count)
+			return false;
+		(*job.decrypt)(index);
+		return true;
+	}
+
+	std::mutex m_run_lock;
+	std::atomic<Job*> m_job{nullptr};
+	std::atomic<s32> m_active{0};
+};
+
 CVolumeWiiCrypted::CVolumeWiiCrypted(std::unique_ptr<IBlobReader> reader, u64 _VolumeOffset,
 									 const unsigned char* _pVolumeKey)
 	: m_pReader(std::move(reader)),
@@ -35,7 +209,16 @@ CVolumeWiiCrypted::CVolumeWiiCrypted(std::unique_ptr<IBlobReader> reader, u64 _V
 	m_dataOffset(0x20000),
 	m_LastDecryptedBlockOffset(-1)
 {
-	mbedtls_aes_setkey_dec(m_AES_ctx.get(), _pVolumeKey, 128);
+	SetKey(_pVolumeKey);
+}
+
+void CVolumeWiiCrypted::SetKey(const u8* key)
+{
+	mbedtls_aes_setkey_dec(m_AES_ctx.get(), key, 128);
+#ifdef _M_X86
+	if (cpu_info.bAES)
+		ExpandDecryptionKeyAESNI(key, m_AESNI_keys.data());
+#endif
 }
 
 bool CVolumeWiiCrypted::ChangePartition(u64 offset)
@@ -45,7 +228,7 @@ bool CVolumeWiiCrypted::ChangePartition(u64 offset)
 
 	u8 volume_key[16];
 	DiscIO::VolumeKeyForPartition(*m_pReader, offset, volume_key);
-	mbedtls_aes_setkey_dec(m_AES_ctx.get(), volume_key, 128);
+	SetKey(volume_key);
 	return true;
 }
 
@@ -70,18 +253,27 @@ bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, bool de
 		u64 Block  = _ReadOffset / s_block_data_size;
 		u64 Offset = _ReadOffset % s_block_data_size;
 
+		// Whole clusters are decrypted straight into the output, a batch at a time
+		u64 WholeBlocks = (Offset == 0) ? _Length / s_block_data_size : 0;
+		if (WholeBlocks > 1)
+		{
+			u64 Count = std::min(WholeBlocks, MAX_BATCH_CLUSTERS);
+			if (!ReadClusters(Block, Count, _pBuffer))
+				return false;
+
+			_Length     -= Count * s_block_data_size;
+			_pBuffer    += Count * s_block_data_size;
+			_ReadOffset += Count * s_block_data_size;
+			continue;
+		}
+
 		if (m_LastDecryptedBlockOffset != Block)
 		{
 			// Read the current block
 			if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + Block * s_block_total_size, s_block_total_size, read_buffer.data()))
 				return false;
 
-			// Decrypt the block's data.
-			// 0x3D0 - 0x3DF in m_pBuffer will be overwritten,
-			// but that won't affect anything, because we won't
-			// use the content of m_pBuffer anymore after this
-			mbedtls_aes_crypt_cbc(m_AES_ctx.get(), MBEDTLS_AES_DECRYPT, s_block_data_size, &read_buffer[0x3D0],
-			              &read_buffer[s_block_header_size], m_LastDecryptedBlock);
+			DecryptCluster(read_buffer.data(), m_LastDecryptedBlock);
 			m_LastDecryptedBlockOffset = Block;
 
 			// The only thing we currently use from the 0x000 - 0x3FF part
@@ -104,6 +296,49 @@ bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, bool de
 	return true;
 }
 
+bool CVolumeWiiCrypted::ReadClusters(u64 first_cluster, u64 count, u8* buffer) const
+{
+	if (m_pReader == nullptr)
+		return false;
+	if (count == 0)
+		return true;
+
+	m_ClusterBuffer.resize(count * s_block_total_size);
+	if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + first_cluster * s_block_total_size,
+	                     count * s_block_total_size, m_ClusterBuffer.data()))
+		return false;
+
+	std::function<void(u64)> decrypt = [this, buffer](u64 i) {
+		DecryptCluster(&m_ClusterBuffer[i * s_block_total_size], buffer + i * s_block_data_size);
+	};
+	if (count >= PARALLEL_CLUSTERS)
+		ClusterDecryptWorker::GetInstance().Run(count, decrypt);
+	else
+		for (u64 i = 0; i < count; i++)
+			decrypt(i);
+
+	// Reads that continue in the middle of the last cluster need it again
+	memcpy(m_LastDecryptedBlock, buffer + (count - 1) * s_block_data_size, s_block_data_size);
+	m_LastDecryptedBlockOffset = first_cluster + count - 1;
+	return true;
+}
+
+void CVolumeWiiCrypted::DecryptCluster(u8* cluster, u8* out) const
+{
+	// The IV is at 0x3D0 in the cluster's header
+#ifdef _M_X86
+	static_assert(s_block_data_size % 64 == 0, "DecryptCBCAESNI works on four blocks at a time");
+	if (cpu_info.bAES)
+	{
+		DecryptCBCAESNI(m_AESNI_keys.data(), &cluster[0x3D0], &cluster[s_block_header_size], out,
+		                s_block_data_size);
+		return;
+	}
+#endif
+	mbedtls_aes_crypt_cbc(m_AES_ctx.get(), MBEDTLS_AES_DECRYPT, s_block_data_size, &cluster[0x3D0],
+	                      &cluster[s_block_header_size], out);
+}
+
 bool CVolumeWiiCrypted::GetTitleID(u64* buffer) const
 {
 	// Tik is at m_VolumeOffset size 0x2A4
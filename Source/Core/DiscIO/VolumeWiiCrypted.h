@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -25,6 +26,9 @@ public:
 	CVolumeWiiCrypted(std::unique_ptr<IBlobReader> reader, u64 _VolumeOffset, const unsigned char* _pVolumeKey);
 	~CVolumeWiiCrypted();
 	bool Read(u64 _Offset, u64 _Length, u8* _pBuffer, bool decrypt) const override;
+	// Reads and decrypts the data of count whole clusters of the partition, several of them
+	// in parallel. Read uses it for the clusters that a read covers completely.
+	bool ReadClusters(u64 first_cluster, u64 count, u8* buffer) const;
 	bool GetTitleID(u64* buffer) const override;
 	std::vector<u8> GetTMD() const override;
 	std::string GetUniqueID() const override;
@@ -52,14 +56,21 @@ private:
 	static const unsigned int s_block_data_size   = 0x7C00;
 	static const unsigned int s_block_total_size  = s_block_header_size + s_block_data_size;
 
+	void SetKey(const u8* key);
+	// Decrypts the data of a raw cluster, overwriting its IV
+	void DecryptCluster(u8* cluster, u8* out) const;
+
 	std::unique_ptr<IBlobReader> m_pReader;
 	std::unique_ptr<mbedtls_aes_context> m_AES_ctx;
+	// The decryption round keys for AES-NI, only set when the host has it
+	std::array<u8, 11 * 16> m_AESNI_keys;
 
 	u64 m_VolumeOffset;
 	u64 m_dataOffset;
 
 	mutable u64 m_LastDecryptedBlockOffset;
 	mutable unsigned char m_LastDecryptedBlock[s_block_data_size];
+	mutable std::vector<u8> m_ClusterBuffer;
 };
 
 } // namespace
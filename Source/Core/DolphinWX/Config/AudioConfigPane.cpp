@@ -40,6 +40,7 @@ void AudioConfigPane::InitializeGUI()
 	m_volume_text = new wxStaticText(this, wxID_ANY, "");
 	m_audio_backend_choice = new wxChoice(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, m_audio_backend_strings);
 	m_audio_latency_spinctrl = new wxSpinCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 30);
+	m_low_latency_checkbox = new wxCheckBox(this, wxID_ANY, _("Low latency mixing"));
 	m_time_stretching_checkbox = new wxCheckBox(this, wxID_ANY, _("Time Stretching"));
 	m_RS_Hack_checkbox = new wxCheckBox(this, wxID_ANY, _("Rogue Squadron 2/3 Hack"));
 	m_dsp_engine_radiobox->Bind(wxEVT_RADIOBOX, &AudioConfigPane::OnDSPEngineRadioBoxChanged, this);
@@ -47,11 +48,13 @@ void AudioConfigPane::InitializeGUI()
 	m_volume_slider->Bind(wxEVT_SLIDER, &AudioConfigPane::OnVolumeSliderChanged, this);
 	m_audio_backend_choice->Bind(wxEVT_CHOICE, &AudioConfigPane::OnAudioBackendChanged, this);
 	m_audio_latency_spinctrl->Bind(wxEVT_SPINCTRL, &AudioConfigPane::OnLatencySpinCtrlChanged, this);
+	m_low_latency_checkbox->Bind(wxEVT_CHECKBOX, &AudioConfigPane::OnLowLatencyCheckBoxChanged, this);
 	m_time_stretching_checkbox->Bind(wxEVT_CHECKBOX, &AudioConfigPane::OnTimeStretchingCheckBoxChanged, this);
 	m_RS_Hack_checkbox->Bind(wxEVT_CHECKBOX, &AudioConfigPane::OnRS_Hack_checkboxChanged, this);
 
 	m_audio_backend_choice->SetToolTip(_("Changing this will have no effect while the emulator is running."));
 	m_audio_latency_spinctrl->SetToolTip(_("Sets the latency (in ms). Higher values may reduce audio crackling."));
+	m_low_latency_checkbox->SetToolTip(_("Keeps less emulated audio buffered before mixing, and with the ALSA and PulseAudio backends requests a small output buffer that only grows on underruns. Reduces latency, but may crackle when the emulation speed is unstable."));
 #if defined(__APPLE__)
 	m_dpl2_decoder_checkbox->SetToolTip(_("Enables Dolby Pro Logic II emulation using 5.1 surround. Not available on OS X."));
 #else
@@ -75,6 +78,7 @@ void AudioConfigPane::InitializeGUI()
 	backend_grid_sizer->Add(m_audio_backend_choice, wxGBPosition(0, 1), wxDefaultSpan, wxALL, 5);
 	backend_grid_sizer->Add(new wxStaticText(this, wxID_ANY, _("Latency:")), wxGBPosition(1, 0), wxDefaultSpan, wxALIGN_CENTER_VERTICAL | wxALL, 5);
 	backend_grid_sizer->Add(m_audio_latency_spinctrl, wxGBPosition(1, 1), wxDefaultSpan, wxALL, 5);
+	backend_grid_sizer->Add(m_low_latency_checkbox, wxGBPosition(2, 0), wxGBSpan(1, 2), wxALL, 5);
 
 	wxStaticBoxSizer* const backend_static_box_sizer = new wxStaticBoxSizer(wxHORIZONTAL, this, _("Backend Settings"));
 	backend_static_box_sizer->Add(backend_grid_sizer, 0, wxEXPAND);
@@ -110,6 +114,7 @@ void AudioConfigPane::LoadGUIValues()
 	m_dpl2_decoder_checkbox->SetValue(startup_params.bDPL2Decoder);
 
 	m_audio_latency_spinctrl->SetValue(startup_params.iLatency);
+	m_low_latency_checkbox->SetValue(startup_params.bLowLatencyAudio);
 
 	m_time_stretching_checkbox->SetValue(startup_params.bTimeStretching);
 	m_RS_Hack_checkbox->SetValue(startup_params.bRSHACK);
@@ -173,6 +178,11 @@ void AudioConfigPane::OnLatencySpinCtrlChanged(wxCommandEvent& event)
 	SConfig::GetInstance().iLatency = m_audio_latency_spinctrl->GetValue();
 }
 
+void AudioConfigPane::OnLowLatencyCheckBoxChanged(wxCommandEvent&)
+{
+	SConfig::GetInstance().bLowLatencyAudio = m_low_latency_checkbox->IsChecked();
+}
+
 void AudioConfigPane::PopulateBackendChoiceBox()
 {
 	for (const std::string& backend : AudioCommon::GetSoundBackends())
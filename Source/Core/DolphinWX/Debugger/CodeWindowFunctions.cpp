@@ -30,6 +30,7 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/Profiler.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 #include "Core/PowerPC/SignatureDB.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
@@ -180,6 +181,9 @@ void CCodeWindow::CreateMenuSymbols(wxMenuBar *pMenuBar)
 
 	wxMenu *pProfilerMenu = new wxMenu;
 	pProfilerMenu->Append(IDM_PROFILE_BLOCKS, _("&Profile blocks"), wxEmptyString, wxITEM_CHECK);
+	pProfilerMenu->Append(IDM_SAMPLE_BLOCKS, _("&Sample blocks"),
+		_("Periodically records which JIT block is running. Much cheaper than profiling blocks."), wxITEM_CHECK);
+	pProfilerMenu->Append(IDM_WRITE_SAMPLES, _("Write samples to profile_samples.folded"));
 	pProfilerMenu->AppendSeparator();
 	pProfilerMenu->Append(IDM_WRITE_PROFILE, _("&Write to profile.txt, show"));
 	pMenuBar->Append(pProfilerMenu, _("&Profiler"));
@@ -196,6 +200,27 @@ void CCodeWindow::OnProfilerMenu(wxCommandEvent& event)
 		Profiler::g_ProfileBlocks = GetMenuBar()->IsChecked(IDM_PROFILE_BLOCKS);
 		Core::SetState(Core::CORE_RUN);
 		break;
+	case IDM_SAMPLE_BLOCKS:
+		if (GetMenuBar()->IsChecked(IDM_SAMPLE_BLOCKS))
+			SamplingProfiler::Start();
+		else
+			SamplingProfiler::Stop();
+		break;
+	case IDM_WRITE_SAMPLES:
+	{
+		bool was_running = Core::GetState() == Core::CORE_RUN;
+		if (was_running)
+			Core::SetState(Core::CORE_PAUSE);
+
+		std::string filename = File::GetUserPath(D_DUMP_IDX) + "Debug/profile_samples.folded";
+		File::CreateFullPath(filename);
+		if (SamplingProfiler::WriteReport(filename))
+			Parent->StatusBarMessage("Wrote samples to %s", filename.c_str());
+
+		if (was_running)
+			Core::SetState(Core::CORE_RUN);
+		break;
+	}
 	case IDM_WRITE_PROFILE:
 		if (Core::GetState() == Core::CORE_RUN)
 			Core::SetState(Core::CORE_PAUSE);
@@ -243,6 +243,8 @@ enum
 
 	// Profiler
 	IDM_PROFILE_BLOCKS,
+	IDM_SAMPLE_BLOCKS,
+	IDM_WRITE_SAMPLES,
 	IDM_WRITE_PROFILE,
 	// --------------------------------------------------------------
 
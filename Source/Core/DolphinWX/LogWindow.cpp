@@ -156,6 +156,8 @@ CLogWindow::~CLogWindow()
 	{
 		m_LogManager->RemoveListener((LogTypes::LOG_TYPE)i, LogListener::LOG_WINDOW_LISTENER);
 	}
+	// Messages are written on another thread, let it finish the ones that are still for us
+	m_LogManager->Flush();
 }
 
 void CLogWindow::OnClose(wxCloseEvent& event)
@@ -2,8 +2,12 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <getopt.h>
 #include <string>
@@ -11,14 +15,18 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/MsgHandler.h"
 #include "Common/Logging/LogManager.h"
 
 #include "Core/BootManager.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/CoreTiming.h"
 #include "Core/Host.h"
+#include "Core/Movie.h"
 #include "Core/State.h"
+#include "Core/HW/SystemTimers.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_usb.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_WiiMote.h"
@@ -30,14 +38,41 @@
 
 static bool rendererHasFocus = true;
 static bool rendererIsFullscreen = false;
-static bool running = true;
+static Common::Flag running(true);
+// Set whenever the main loop has to check whether it should stop.
+static Common::Event s_main_loop_event;
+
+// Batch options, see the usage message.
+static u64 s_frame_limit = 0;
+static bool s_exit_on_movie_end = false;
+static std::atomic<u64> s_frame_count{0};
+
+static void RequestStop()
+{
+	running.Clear();
+	s_main_loop_event.Set();
+}
+
+// Runs on the GPU thread.
+static void OnFrame()
+{
+	u64 frames = ++s_frame_count;
+	if (s_frame_limit && frames == s_frame_limit)
+		RequestStop();
+	if (s_exit_on_movie_end && !Movie::IsPlayingInput())
+		RequestStop();
+}
 
 class Platform
 {
 public:
 	virtual void Init() {}
 	virtual void SetTitle(const std::string &title) {}
-	virtual void MainLoop() { while(running) {} }
+	virtual void MainLoop()
+	{
+		while (running.IsSet())
+			s_main_loop_event.Wait();
+	}
 	virtual void Shutdown() {}
 	virtual ~Platform() {}
 };
@@ -51,7 +86,7 @@ static Common::Event updateMainFrameEvent;
 void Host_Message(int Id)
 {
 	if (Id == WM_USER_STOP)
-		running = false;
+		RequestStop();
 }
 
 static void* s_window_handle = nullptr;
@@ -188,7 +223,7 @@ class PlatformX11 : public Platform
 		}
 
 		// The actual loop
-		while (running)
+		while (running.IsSet())
 		{
 			XEvent event;
 			KeySym key;
@@ -255,7 +290,7 @@ class PlatformX11 : public Platform
 					break;
 				case ClientMessage:
 					if ((unsigned long) event.xclient.data.l[0] == XInternAtom(dpy, "WM_DELETE_WINDOW", False))
-						running = false;
+						RequestStop();
 					break;
 				}
 			}
@@ -271,7 +306,7 @@ class PlatformX11 : public Platform
 					     &borderDummy, &depthDummy);
 				rendererIsFullscreen = false;
 			}
-			usleep(100000);
+			s_main_loop_event.WaitFor(std::chrono::milliseconds(100));
 		}
 	}
 
@@ -302,19 +337,37 @@ static Platform* GetPlatform()
 int main(int argc, char* argv[])
 {
 	int ch, help = 0;
+	bool print_stats = false;
+	std::string movie;
 	struct option longopts[] = {
-		{ "exec",    no_argument, nullptr, 'e' },
-		{ "help",    no_argument, nullptr, 'h' },
-		{ "version", no_argument, nullptr, 'v' },
-		{ nullptr,      0,           nullptr,  0  }
+		{ "exec",              no_argument,       nullptr, 'e' },
+		{ "frames",            required_argument, nullptr, 'f' },
+		{ "movie",             required_argument, nullptr, 'm' },
+		{ "exit-on-movie-end", no_argument,       nullptr, 'M' },
+		{ "stats",             no_argument,       nullptr, 's' },
+		{ "help",              no_argument,       nullptr, 'h' },
+		{ "version",           no_argument,       nullptr, 'v' },
+		{ nullptr,             0,                 nullptr,  0  }
 	};
 
-	while ((ch = getopt_long(argc, argv, "eh?v", longopts, 0)) != -1)
+	while ((ch = getopt_long(argc, argv, "ef:m:Msh?v", longopts, 0)) != -1)
 	{
 		switch (ch)
 		{
 		case 'e':
 			break;
+		case 'f':
+			s_frame_limit = strtoull(optarg, nullptr, 10);
+			break;
+		case 'm':
+			movie = optarg;
+			break;
+		case 'M':
+			s_exit_on_movie_end = true;
+			break;
+		case 's':
+			print_stats = true;
+			break;
 		case 'h':
 		case '?':
 			help = 1;
@@ -329,10 +382,20 @@ int main(int argc, char* argv[])
 	{
 		fprintf(stderr, "%s\n\n", scm_rev_str);
 		fprintf(stderr, "A multi-platform GameCube/Wii emulator\n\n");
-		fprintf(stderr, "Usage: %s [-e <file>] [-h] [-v]\n", argv[0]);
-		fprintf(stderr, "  -e, --exec     Load the specified file\n");
-		fprintf(stderr, "  -h, --help     Show this help message\n");
-		fprintf(stderr, "  -v, --version  Print version and exit\n");
+		fprintf(stderr, "Usage: %s [-e <file>] [-f <frames>] [-m <movie>] [-M] [-s] [-h] [-v]\n", argv[0]);
+		fprintf(stderr, "  -e, --exec               Load the specified file\n");
+		fprintf(stderr, "  -f, --frames=N           Stop after N frames\n");
+		fprintf(stderr, "  -m, --movie=FILE         Play back the specified input movie\n");
+		fprintf(stderr, "  -M, --exit-on-movie-end  Stop when the movie has been played back\n");
+		fprintf(stderr, "  -s, --stats              Print frame and speed statistics on exit\n");
+		fprintf(stderr, "  -h, --help               Show this help message\n");
+		fprintf(stderr, "  -v, --version            Print version and exit\n");
+		return 1;
+	}
+
+	if (s_exit_on_movie_end && movie.empty())
+	{
+		fprintf(stderr, "--exit-on-movie-end requires --movie\n");
 		return 1;
 	}
 
@@ -348,6 +411,16 @@ int main(int argc, char* argv[])
 
 	platform->Init();
 
+	if (!movie.empty() && !Movie::PlayInput(movie))
+	{
+		fprintf(stderr, "Could not play movie %s\n", movie.c_str());
+		return 1;
+	}
+
+	// The core also stops on its own, e.g. when the game shuts down.
+	Core::SetOnStoppedCallback(RequestStop);
+	Core::SetOnFrameCallback(OnFrame);
+
 	if (!BootManager::BootCore(argv[optind]))
 	{
 		fprintf(stderr, "Could not boot %s\n", argv[optind]);
@@ -357,11 +430,26 @@ int main(int argc, char* argv[])
 	while (!Core::IsRunning())
 		updateMainFrameEvent.Wait();
 
+	const auto start_time = std::chrono::steady_clock::now();
 	platform->MainLoop();
 	Core::Stop();
 	while (PowerPC::GetState() != PowerPC::CPU_POWERDOWN)
 		updateMainFrameEvent.Wait();
 
+	if (print_stats)
+	{
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+		const double emulated_seconds = (double)CoreTiming::GetTicks() / SystemTimers::GetTicksPerSecond();
+		const u64 frames = s_frame_count.load();
+		printf("frames: %" PRIu64 "\n", frames);
+		printf("time: %.3f s\n", seconds);
+		printf("fps: %.2f\n", seconds > 0 ? frames / seconds : 0.0);
+		printf("emulated time: %.3f s\n", emulated_seconds);
+		printf("speed: %.1f%%\n", seconds > 0 ? emulated_seconds * 100 / seconds : 0.0);
+	}
+
+	Core::SetOnFrameCallback(nullptr);
+
 	Core::Shutdown();
 	platform->Shutdown();
 	UICommon::Shutdown();
@@ -288,6 +288,12 @@ void NetPlaySetupFrame::MakeNetPlayDiag(int port, const std::string &game, bool
 	GetTraversalServer(netplay_section, &centralServer);
 
 	netplay_client = new NetPlayClient(ip, (u16)port, npd, WxStrToStr(m_nickname_text->GetValue()), trav, centralServer, (u16) centralPort);
+
+	// Only set in the ini, for trying out rollback over a local connection.
+	u32 simulated_latency;
+	netplay_section.Get("SimulatedLatency", &simulated_latency, 0);
+	netplay_client->SetSimulatedLatency(simulated_latency);
+
 	if (netplay_client->IsConnected())
 	{
 		npd->Show();
@@ -168,6 +168,10 @@ NetPlayDialog::NetPlayDialog(wxWindow* const parent, const CGameListCtrl* const
 
 	player_szr->Add(m_player_lbox, 1, wxEXPAND);
 
+	m_input_latency_label = new wxStaticText(panel, wxID_ANY, wxEmptyString);
+	m_input_latency_label->SetToolTip(_("How long input from the other players waited before the game used it."));
+	player_szr->Add(m_input_latency_label, 0, wxEXPAND | wxTOP, 5);
+
 	if (m_is_hosting)
 	{
 		m_player_lbox->Bind(wxEVT_LISTBOX, &NetPlayDialog::OnPlayerSelect, this);
@@ -204,6 +208,10 @@ NetPlayDialog::NetPlayDialog(wxWindow* const parent, const CGameListCtrl* const
 
 		m_memcard_write = new wxCheckBox(panel, wxID_ANY, _("Write memcards/SD"));
 		bottom_szr->Add(m_memcard_write, 0, wxCENTER);
+
+		m_rollback_chkbox = new wxCheckBox(panel, wxID_ANY, _("Rollback"));
+		m_rollback_chkbox->SetToolTip(_("Predict the other players' GameCube controller input instead of delaying everyone's input by the buffer size, and emulate frames again when a prediction was wrong.\nNeeds a fast CPU. Wii Remotes and Wii games still use the buffer."));
+		bottom_szr->Add(m_rollback_chkbox, 0, wxCENTER);
 	}
 
 	m_record_chkbox = new wxCheckBox(panel, wxID_ANY, _("Record input"));
@@ -265,6 +273,7 @@ void NetPlayDialog::GetNetSettings(NetSettings &settings)
 	settings.m_DSPHLE = instance.bDSPHLE;
 	settings.m_DSPEnableJIT = instance.m_DSPEnableJIT;
 	settings.m_WriteToMemcard = m_memcard_write->GetValue();
+	settings.m_Rollback = m_rollback_chkbox->GetValue();
 	settings.m_OCEnable = instance.m_OCEnable;
 	settings.m_OCFactor = instance.m_OCFactor;
 	settings.m_EXIDevice[0] = instance.m_EXIDevice[0];
@@ -329,6 +338,7 @@ void NetPlayDialog::OnMsgStartGame()
 	{
 		m_start_btn->Disable();
 		m_memcard_write->Disable();
+		m_rollback_chkbox->Disable();
 		m_game_btn->Disable();
 		m_player_config_btn->Disable();
 	}
@@ -344,6 +354,7 @@ void NetPlayDialog::OnMsgStopGame()
 	{
 		m_start_btn->Enable();
 		m_memcard_write->Enable();
+		m_rollback_chkbox->Enable();
 		m_game_btn->Enable();
 		m_player_config_btn->Enable();
 	}
@@ -411,6 +422,9 @@ void NetPlayDialog::OnThread(wxThreadEvent& event)
 	}
 	numPlayers = m_playerids.size();
 
+	m_input_latency_label->SetLabel(StrToWxStr(netplay_client->GetInputLatencyString() + "\n" +
+		netplay_client->GetRollbackString()));
+
 	switch (event.GetId())
 	{
 	case NP_GUI_EVT_CHANGE_GAME:
@@ -83,6 +83,7 @@ private:
 	wxTextCtrl*   m_chat_text;
 	wxTextCtrl*   m_chat_msg_text;
 	wxCheckBox*   m_memcard_write;
+	wxCheckBox*   m_rollback_chkbox;
 	wxCheckBox*   m_record_chkbox;
 
 	std::string   m_selected_game;
@@ -91,6 +92,7 @@ private:
 	wxButton*     m_start_btn;
 	wxButton*     m_kick_btn;
 	wxStaticText* m_host_label;
+	wxStaticText* m_input_latency_label;
 	wxChoice*     m_host_type_choice;
 	wxButton*     m_host_copy_btn;
 	bool          m_host_copy_btn_is_retry;
@@ -38,6 +38,8 @@ using namespace ciface::ExpressionParser;
 namespace
 {
 const ControlState INPUT_DETECT_THRESHOLD = 0.55;
+// How often the polling thread updates the devices
+const int POLLING_INTERVAL = 1; // ms
 }
 
 ControllerInterface g_controller_interface;
@@ -83,6 +85,9 @@ void ControllerInterface::Initialize(void* const hwnd)
 #endif
 
 	m_is_init = true;
+
+	if (m_polling_thread_enabled)
+		StartPollingThread();
 }
 
 void ControllerInterface::Reinitialize()
@@ -104,6 +109,8 @@ void ControllerInterface::Shutdown()
 	if (!m_is_init)
 		return;
 
+	StopPollingThread();
+
 	for (ciface::Core::Device* d : m_devices)
 	{
 		// Set outputs to ZERO before destroying device
@@ -146,10 +153,56 @@ void ControllerInterface::Shutdown()
 //
 void ControllerInterface::UpdateInput()
 {
+	if (m_polling_thread_running.IsSet())
+		return;
+
 	for (ciface::Core::Device* d : m_devices)
 		d->UpdateInput();
 }
 
+void ControllerInterface::SetPollingThread(bool enable)
+{
+	m_polling_thread_enabled = enable;
+	if (enable && m_is_init)
+		StartPollingThread();
+	else if (!enable)
+		StopPollingThread();
+}
+
+void ControllerInterface::StartPollingThread()
+{
+	if (m_polling_thread_running.TestAndSet())
+		m_polling_thread = std::thread(&ControllerInterface::PollingThread, this);
+}
+
+void ControllerInterface::StopPollingThread()
+{
+	if (!m_polling_thread_running.TestAndClear())
+		return;
+
+	m_polling_thread.join();
+	ciface::Core::Device::Input::s_use_snapshots = false;
+}
+
+void ControllerInterface::PollingThread()
+{
+	Common::SetCurrentThreadName("Input polling thread");
+
+	while (m_polling_thread_running.IsSet())
+	{
+		for (ciface::Core::Device* d : m_devices)
+		{
+			d->UpdateInput();
+			for (ciface::Core::Device::Input* i : d->Inputs())
+				i->UpdateSnapshot();
+		}
+		// Only read the snapshots once they have all been taken
+		ciface::Core::Device::Input::s_use_snapshots = true;
+
+		Common::SleepCurrentThread(POLLING_INTERVAL);
+	}
+}
+
 //
 // InputReference :: State
 //
@@ -218,23 +271,25 @@ ciface::Core::Device::Control* ControllerInterface::InputReference::Detect(const
 		i = device->Inputs().begin(),
 		e = device->Inputs().end();
 	for (std::vector<bool>::iterator state = states.begin(); i != e; ++i)
-		*state++ = ((*i)->GetState() > (1 - INPUT_DETECT_THRESHOLD));
+		*state++ = ((*i)->GetPolledState() > (1 - INPUT_DETECT_THRESHOLD));
 
 	while (time < ms)
 	{
-		device->UpdateInput();
+		// The polling thread updates the device otherwise
+		if (!g_controller_interface.IsPollingThreadRunning())
+			device->UpdateInput();
 		i = device->Inputs().begin();
 		for (std::vector<bool>::iterator state = states.begin(); i != e; ++i,++state)
 		{
 			// detected an input
-			if ((*i)->IsDetectable() && (*i)->GetState() > INPUT_DETECT_THRESHOLD)
+			if ((*i)->IsDetectable() && (*i)->GetPolledState() > INPUT_DETECT_THRESHOLD)
 			{
 				// input was released at some point during Detect call
 				// return the detected input
 				if (false == *state)
 					return *i;
 			}
-			else if ((*i)->GetState() < (1 - INPUT_DETECT_THRESHOLD))
+			else if ((*i)->GetPolledState() < (1 - INPUT_DETECT_THRESHOLD))
 			{
 				*state = false;
 			}
@@ -8,9 +8,11 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Flag.h"
 #include "Common/Thread.h"
 #include "InputCommon/ControllerInterface/Device.h"
 #include "InputCommon/ControllerInterface/ExpressionParser.h"
@@ -118,7 +120,7 @@ public:
 		ciface::Core::Device::Control* Detect(const unsigned int ms, ciface::Core::Device* const device) override;
 	};
 
-	ControllerInterface() : m_is_init(false), m_hwnd(nullptr) {}
+	ControllerInterface() : m_is_init(false), m_hwnd(nullptr), m_polling_thread_enabled(false) {}
 
 	void Initialize(void* const hwnd);
 	void Reinitialize();
@@ -128,9 +130,23 @@ public:
 	void UpdateReference(ControlReference* control, const ciface::Core::DeviceQualifier& default_device) const;
 	void UpdateInput();
 
+	// Polls all devices on a separate thread instead of in UpdateInput, which does nothing then.
+	// Inputs are read from the snapshots the thread takes after every poll.
+	// Stays enabled across Shutdown/Initialize, e.g. when the devices are refreshed.
+	void SetPollingThread(bool enable);
+	bool IsPollingThreadRunning() const { return m_polling_thread_running.IsSet(); }
+
 private:
+	void StartPollingThread();
+	void StopPollingThread();
+	void PollingThread();
+
 	bool   m_is_init;
 	void*  m_hwnd;
+
+	bool m_polling_thread_enabled;
+	Common::Flag m_polling_thread_running;
+	std::thread m_polling_thread;
 };
 
 extern ControllerInterface g_controller_interface;
@@ -66,6 +66,8 @@ Device::Output* Device::FindOutput(const std::string &name) const
 	return nullptr;
 }
 
+std::atomic<bool> Device::Input::s_use_snapshots{false};
+
 bool Device::Control::InputGateOn()
 {
 	if (SConfig::GetInstance().m_BackgroundInput)
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -42,7 +43,7 @@ public:
 		virtual std::string GetName() const = 0;
 		virtual ~Control() {}
 
-		bool InputGateOn();
+		static bool InputGateOn();
 
 		virtual Input* ToInput() { return nullptr; }
 		virtual Output* ToOutput() { return nullptr; }
@@ -61,15 +62,32 @@ public:
 
 		virtual ControlState GetState() const = 0;
 
+		// The state as of the last poll of the input polling thread when it runs,
+		// so that readers don't race with the device being updated
+		ControlState GetPolledState() const
+		{
+			if (s_use_snapshots.load(std::memory_order_relaxed))
+				return m_snapshot.load(std::memory_order_relaxed);
+			return GetState();
+		}
+
 		ControlState GetGatedState()
 		{
 			if (InputGateOn())
-				return GetState();
+				return GetPolledState();
 			else
 				return 0.0;
 		}
 
+		// Called by the input polling thread after the device was updated
+		void UpdateSnapshot() { m_snapshot.store(GetState(), std::memory_order_relaxed); }
+
 		Input* ToInput() override { return this; }
+
+		static std::atomic<bool> s_use_snapshots;
+
+	private:
+		std::atomic<ControlState> m_snapshot{0.0};
 	};
 
 	//
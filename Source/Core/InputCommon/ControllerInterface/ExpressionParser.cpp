@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "Common/CommonFuncs.h"
 #include "InputCommon/ControllerInterface/ExpressionParser.h"
 
 using namespace ciface::Core;
@@ -50,6 +51,47 @@ inline std::string OpName(TokenType op)
 	}
 }
 
+// Used both to evaluate programs and to fold constants while compiling them
+static inline ControlState ApplyBinary(Opcode op, ControlState lhs, ControlState rhs)
+{
+	switch (op)
+	{
+	case OP_AND:
+		return std::min(lhs, rhs);
+	case OP_OR:
+		return std::max(lhs, rhs);
+	case OP_ADD:
+		return std::min(lhs + rhs, 1.0);
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+static Opcode BinaryOpcode(TokenType op)
+{
+	switch (op)
+	{
+	case TOK_AND:
+		return OP_AND;
+	case TOK_OR:
+		return OP_OR;
+	case TOK_ADD:
+		return OP_ADD;
+	default:
+		assert(false);
+		return OP_AND;
+	}
+}
+
+static void EmitConst(std::vector<Instruction> &program, ControlState value)
+{
+	Instruction instr;
+	instr.op = OP_CONST;
+	instr.value = value;
+	program.push_back(instr);
+}
+
 class Token
 {
 public:
@@ -215,10 +257,13 @@ class ExpressionNode
 {
 public:
 	virtual ~ExpressionNode() {}
-	virtual ControlState GetValue() { return 0; }
-	virtual void SetValue(ControlState state) {}
 	virtual int CountNumControls() { return 0; }
 	virtual operator std::string() { return ""; }
+
+	// Appends the instructions computing GetValue() to the program
+	virtual void Compile(std::vector<Instruction> &program) { EmitConst(program, 0.0); }
+	// Appends the outputs SetValue() would set
+	virtual void CollectOutputs(std::vector<OutputTarget> &outputs, bool inverted) {}
 };
 
 class DummyExpression : public ExpressionNode
@@ -228,15 +273,6 @@ public:
 
 	DummyExpression(const std::string& name_) : name(name_) {}
 
-	ControlState GetValue() override
-	{
-		return 0.0;
-	}
-
-	void SetValue(ControlState value) override
-	{
-	}
-
 	int CountNumControls() override
 	{
 		return 0;
@@ -256,19 +292,30 @@ public:
 
 	ControlExpression(ControlQualifier qualifier_, Device::Control *control_) : qualifier(qualifier_), control(control_) {}
 
-	ControlState GetValue() override
+	int CountNumControls() override
 	{
-		return control->ToInput()->GetGatedState();
+		return 1;
 	}
 
-	void SetValue(ControlState value) override
+	void Compile(std::vector<Instruction> &program) override
 	{
-		control->ToOutput()->SetGatedState(value);
+		Device::Input *input = control->ToInput();
+		if (!input)
+		{
+			EmitConst(program, 0.0);
+			return;
+		}
+		Instruction instr;
+		instr.op = OP_INPUT;
+		instr.input = input;
+		program.push_back(instr);
 	}
 
-	int CountNumControls() override
+	void CollectOutputs(std::vector<OutputTarget> &outputs, bool inverted) override
 	{
-		return 1;
+		Device::Output *output = control->ToOutput();
+		if (output)
+			outputs.push_back({output, inverted});
 	}
 
 	operator std::string() override
@@ -291,35 +338,36 @@ public:
 		delete rhs;
 	}
 
-	ControlState GetValue() override
+	int CountNumControls() override
 	{
-		ControlState lhsValue = lhs->GetValue();
-		ControlState rhsValue = rhs->GetValue();
-		switch (op)
+		return lhs->CountNumControls() + rhs->CountNumControls();
+	}
+
+	void Compile(std::vector<Instruction> &program) override
+	{
+		lhs->Compile(program);
+		rhs->Compile(program);
+
+		size_t size = program.size();
+		if (program[size - 2].op == OP_CONST && program[size - 1].op == OP_CONST)
 		{
-		case TOK_AND:
-			return std::min(lhsValue, rhsValue);
-		case TOK_OR:
-			return std::max(lhsValue, rhsValue);
-		case TOK_ADD:
-			return std::min(lhsValue + rhsValue, 1.0);
-		default:
-			assert(false);
-			return 0;
+			ControlState value = ApplyBinary(BinaryOpcode(op), program[size - 2].value, program[size - 1].value);
+			program.resize(size - 2);
+			EmitConst(program, value);
+			return;
 		}
+
+		Instruction instr;
+		instr.op = BinaryOpcode(op);
+		program.push_back(instr);
 	}
 
-	void SetValue(ControlState value) override
+	void CollectOutputs(std::vector<OutputTarget> &outputs, bool inverted) override
 	{
 		// Don't do anything special with the op we have.
 		// Treat "A & B" the same as "A | B".
-		lhs->SetValue(value);
-		rhs->SetValue(value);
-	}
-
-	int CountNumControls() override
-	{
-		return lhs->CountNumControls() + rhs->CountNumControls();
+		lhs->CollectOutputs(outputs, inverted);
+		rhs->CollectOutputs(outputs, inverted);
 	}
 
 	operator std::string() override
@@ -340,35 +388,28 @@ public:
 		delete inner;
 	}
 
-	ControlState GetValue() override
+	int CountNumControls() override
 	{
-		ControlState value = inner->GetValue();
-		switch (op)
-		{
-		case TOK_NOT:
-			return 1.0 - value;
-		default:
-			assert(false);
-			return 0;
-		}
+		return inner->CountNumControls();
 	}
 
-	void SetValue(ControlState value) override
+	void Compile(std::vector<Instruction> &program) override
 	{
-		switch (op)
+		inner->Compile(program);
+		if (program.back().op == OP_CONST)
 		{
-		case TOK_NOT:
-			inner->SetValue(1.0 - value);
-			break;
-
-		default:
-			assert(false);
+			program.back().value = 1.0 - program.back().value;
+			return;
 		}
+
+		Instruction instr;
+		instr.op = OP_NOT;
+		program.push_back(instr);
 	}
 
-	int CountNumControls() override
+	void CollectOutputs(std::vector<OutputTarget> &outputs, bool inverted) override
 	{
-		return inner->CountNumControls();
+		inner->CollectOutputs(outputs, !inverted);
 	}
 
 	operator std::string() override
@@ -549,25 +590,77 @@ private:
 	}
 };
 
-ControlState Expression::GetValue()
+ControlState Expression::GetValue() const
 {
-	return node->GetValue();
+	// The gate is the same for every control, only check it once
+	const bool gate = Device::Control::InputGateOn();
+
+	if (m_program.size() == 1)
+	{
+		const Instruction &instr = m_program[0];
+		if (instr.op == OP_CONST)
+			return instr.value;
+		return gate ? instr.input->GetPolledState() : 0.0;
+	}
+
+	ControlState small_stack[16] = {};
+	std::vector<ControlState> large_stack;
+	ControlState *stack = small_stack;
+	if (m_stack_size > ArraySize(small_stack))
+	{
+		large_stack.resize(m_stack_size);
+		stack = large_stack.data();
+	}
+
+	u32 sp = 0;
+	for (const Instruction &instr : m_program)
+	{
+		switch (instr.op)
+		{
+		case OP_CONST:
+			stack[sp++] = instr.value;
+			break;
+		case OP_INPUT:
+			stack[sp++] = gate ? instr.input->GetPolledState() : 0.0;
+			break;
+		case OP_NOT:
+			stack[sp - 1] = 1.0 - stack[sp - 1];
+			break;
+		default:
+			sp--;
+			stack[sp - 1] = ApplyBinary(instr.op, stack[sp - 1], stack[sp]);
+			break;
+		}
+	}
+	return stack[0];
 }
 
 void Expression::SetValue(ControlState value)
 {
-	node->SetValue(value);
-}
+	if (m_outputs.empty() || !Device::Control::InputGateOn())
+		return;
 
-Expression::Expression(ExpressionNode *node_)
-{
-	node = node_;
-	num_controls = node->CountNumControls();
+	for (const OutputTarget &target : m_outputs)
+		target.output->SetState(target.inverted ? 1.0 - value : value);
 }
 
-Expression::~Expression()
+// Compiles the tree, which is not kept
+Expression::Expression(ExpressionNode *node)
 {
+	num_controls = node->CountNumControls();
+	node->Compile(m_program);
+	node->CollectOutputs(m_outputs, false);
 	delete node;
+
+	m_stack_size = 0;
+	u32 depth = 0;
+	for (const Instruction &instr : m_program)
+	{
+		if (instr.op == OP_CONST || instr.op == OP_INPUT)
+			m_stack_size = std::max(m_stack_size, ++depth);
+		else if (instr.op != OP_NOT)
+			depth--;
+	}
 }
 
 static ExpressionParseStatus ParseExpressionInner(const std::string& str, ControlFinder &finder, Expression **expr_out)
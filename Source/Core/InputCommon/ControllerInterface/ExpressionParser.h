@@ -5,6 +5,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
 #include "InputCommon/ControllerInterface/Device.h"
 
 namespace ciface
@@ -43,17 +46,48 @@ private:
 	bool is_input;
 };
 
+// Parsed expressions are compiled to a flat program in postfix order, evaluated with a
+// small stack. Operations on constants, e.g. controls that are not connected, are folded.
+enum Opcode : u8
+{
+	OP_CONST,
+	OP_INPUT,
+	OP_AND,
+	OP_OR,
+	OP_ADD,
+	OP_NOT,
+};
+
+struct Instruction
+{
+	Opcode op;
+	union
+	{
+		ControlState value;
+		Core::Device::Input *input;
+	};
+};
+
+// An output bound by the expression, with the NOTs on the way to it applied
+struct OutputTarget
+{
+	Core::Device::Output *output;
+	bool inverted;
+};
+
 class ExpressionNode;
 class Expression
 {
 public:
-	Expression() : node(nullptr) {}
 	Expression(ExpressionNode *node);
-	~Expression();
-	ControlState GetValue();
+	ControlState GetValue() const;
 	void SetValue (ControlState state);
 	int num_controls;
-	ExpressionNode *node;
+
+private:
+	std::vector<Instruction> m_program;
+	std::vector<OutputTarget> m_outputs;
+	u32 m_stack_size;
 };
 
 enum ExpressionParseStatus
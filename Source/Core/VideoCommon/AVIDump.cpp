@@ -6,7 +6,16 @@
 #define __STDC_CONSTANT_MACROS 1
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -17,6 +26,7 @@ extern "C" {
 
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Thread.h"
 #include "Common/Logging/Log.h"
 
 #include "Core/ConfigManager.h"
@@ -46,6 +56,31 @@ static u64 s_last_frame;
 static bool s_start_dumping = false;
 static u64 s_last_pts;
 
+// Frames are converted and encoded on their own thread, the video thread only copies them into
+// a pooled buffer. When the queue is full AddFrame either waits for the encoder or drops the frame.
+static const size_t FRAME_QUEUE_SIZE = 8;
+
+struct QueuedFrame
+{
+	std::vector<u8> data;
+	int width;
+	int height;
+	s64 pts;
+};
+
+static std::thread s_encoder_thread;
+static std::mutex s_queue_lock;
+static std::condition_variable s_queue_cond;
+static std::deque<QueuedFrame> s_frame_queue;
+static std::vector<std::vector<u8>> s_buffer_pool;
+static bool s_encoder_stop = false;
+
+// Back-pressure statistics, logged when dumping stops.
+static u64 s_frames_queued;
+static u64 s_frames_dropped;
+static u64 s_blocked_us;
+static size_t s_max_queue_depth;
+
 static void InitAVCodec()
 {
 	static bool first_run = true;
@@ -118,6 +153,8 @@ bool AVIDump::CreateFile()
 	s_stream->codec->time_base.den = VideoInterface::GetTargetRefreshRate();
 	s_stream->codec->gop_size = 12;
 	s_stream->codec->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGRA : AV_PIX_FMT_YUV420P;
+	// 0 lets libavcodec pick a thread count for the host.
+	s_stream->codec->thread_count = std::max(g_Config.iDumpEncoderThreads, 0);
 
 	if (!(codec = avcodec_find_encoder(s_stream->codec->codec_id)) ||
 	    (avcodec_open2(s_stream->codec, codec, nullptr) < 0))
@@ -142,6 +179,13 @@ bool AVIDump::CreateFile()
 
 	avformat_write_header(s_format_context, nullptr);
 
+	s_frames_queued = 0;
+	s_frames_dropped = 0;
+	s_blocked_us = 0;
+	s_max_queue_depth = 0;
+	s_encoder_stop = false;
+	s_encoder_thread = std::thread(EncoderThread);
+
 	return true;
 }
 
@@ -152,30 +196,105 @@ static void PreparePacket(AVPacket* pkt)
 	pkt->size = 0;
 }
 
-void AVIDump::AddFrame(const u8* data, int width, int height)
+static void WritePacket(AVPacket* pkt)
 {
-	avpicture_fill((AVPicture*)s_src_frame, const_cast<u8*>(data), s_pix_fmt, width, height);
+	// Write the compressed frame in the media file.
+	if (pkt->pts != (s64)AV_NOPTS_VALUE)
+	{
+		pkt->pts = av_rescale_q(pkt->pts,
+		                        s_stream->codec->time_base, s_stream->time_base);
+	}
+	if (pkt->dts != (s64)AV_NOPTS_VALUE)
+	{
+		pkt->dts = av_rescale_q(pkt->dts,
+		                        s_stream->codec->time_base, s_stream->time_base);
+	}
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(56, 60, 100)
+	if (s_stream->codec->coded_frame->key_frame)
+		pkt->flags |= AV_PKT_FLAG_KEY;
+#endif
+	pkt->stream_index = s_stream->index;
+	av_interleaved_write_frame(s_format_context, pkt);
+}
+
+// Called on the encoder thread.
+static void EncodeFrame(const QueuedFrame& frame)
+{
+	avpicture_fill((AVPicture*)s_src_frame, const_cast<u8*>(frame.data.data()), s_pix_fmt, frame.width, frame.height);
 
 	// Convert image from {BGR24, RGBA} to desired pixel format, and scale to initial
 	// width and height
 	if ((s_sws_context = sws_getCachedContext(s_sws_context,
-	                                          width, height, s_pix_fmt,
+	                                          frame.width, frame.height, s_pix_fmt,
 	                                          s_width, s_height, s_stream->codec->pix_fmt,
 	                                          SWS_BICUBIC, nullptr, nullptr, nullptr)))
 	{
 		sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0,
-		          height, s_scaled_frame->data, s_scaled_frame->linesize);
+		          frame.height, s_scaled_frame->data, s_scaled_frame->linesize);
 	}
 
 	s_scaled_frame->format = s_stream->codec->pix_fmt;
 	s_scaled_frame->width = s_width;
 	s_scaled_frame->height = s_height;
+	s_scaled_frame->pts = frame.pts;
 
-	// Encode and write the image.
+	// Encode and write the image. Packets delayed by the encoder are written when it is flushed.
 	AVPacket pkt;
 	PreparePacket(&pkt);
 	int got_packet = 0;
+	int error = avcodec_encode_video2(s_stream->codec, &pkt, s_scaled_frame, &got_packet);
+	if (!error && got_packet)
+		WritePacket(&pkt);
+	if (error)
+		ERROR_LOG(VIDEO, "Error while encoding video: %d", error);
+}
+
+static void FlushEncoder()
+{
+	AVPacket pkt;
+	int got_packet = 1;
 	int error = 0;
+	while (!error && got_packet)
+	{
+		PreparePacket(&pkt);
+		error = avcodec_encode_video2(s_stream->codec, &pkt, nullptr, &got_packet);
+		if (!error && got_packet)
+			WritePacket(&pkt);
+	}
+	if (error)
+		ERROR_LOG(VIDEO, "Error while flushing video encoder: %d", error);
+}
+
+void AVIDump::EncoderThread()
+{
+	Common::SetCurrentThreadName("Frame dump encoder");
+
+	std::unique_lock<std::mutex> lk(s_queue_lock);
+	while (true)
+	{
+		s_queue_cond.wait(lk, [] { return s_encoder_stop || !s_frame_queue.empty(); });
+		if (s_frame_queue.empty())
+			break;
+
+		QueuedFrame frame = std::move(s_frame_queue.front());
+		s_frame_queue.pop_front();
+		lk.unlock();
+		s_queue_cond.notify_all();
+
+		EncodeFrame(frame);
+
+		lk.lock();
+		s_buffer_pool.push_back(std::move(frame.data));
+	}
+	lk.unlock();
+
+	// Frames still in the queue were encoded above, so this only drains the codec.
+	FlushEncoder();
+}
+
+void AVIDump::AddFrame(const u8* data, int width, int height)
+{
+	// The timestamps are taken here, on the thread that produced the frame.
 	u64 delta;
 	s64 last_pts;
 	// Check to see if the first frame being dumped is the first frame of output from the emulator.
@@ -192,46 +311,61 @@ void AVIDump::AddFrame(const u8* data, int width, int height)
 		last_pts = (s_last_pts * s_stream->codec->time_base.den) / SystemTimers::GetTicksPerSecond();
 	}
 	u64 pts_in_ticks = s_last_pts + delta;
-	s_scaled_frame->pts = (pts_in_ticks * s_stream->codec->time_base.den) / SystemTimers::GetTicksPerSecond();
-	if (s_scaled_frame->pts != last_pts)
-	{
-		s_last_frame = CoreTiming::GetTicks();
-		s_last_pts = pts_in_ticks;
-		error = avcodec_encode_video2(s_stream->codec, &pkt, s_scaled_frame, &got_packet);
-	}
-	while (!error && got_packet)
+	s64 pts = (pts_in_ticks * s_stream->codec->time_base.den) / SystemTimers::GetTicksPerSecond();
+	if (pts == last_pts)
+		return;
+	s_last_frame = CoreTiming::GetTicks();
+	s_last_pts = pts_in_ticks;
+
+	std::unique_lock<std::mutex> lk(s_queue_lock);
+	if (s_frame_queue.size() >= FRAME_QUEUE_SIZE)
 	{
-		// Write the compressed frame in the media file.
-		if (pkt.pts != (s64)AV_NOPTS_VALUE)
+		if (g_Config.bDumpFramesDropWhenBehind)
 		{
-			pkt.pts = av_rescale_q(pkt.pts,
-			                       s_stream->codec->time_base, s_stream->time_base);
+			s_frames_dropped++;
+			return;
 		}
-		if (pkt.dts != (s64)AV_NOPTS_VALUE)
-		{
-			pkt.dts = av_rescale_q(pkt.dts,
-			                       s_stream->codec->time_base, s_stream->time_base);
-		}
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(56, 60, 100)
-		if (s_stream->codec->coded_frame->key_frame)
-			pkt.flags |= AV_PKT_FLAG_KEY;
-#endif
-		pkt.stream_index = s_stream->index;
-		av_interleaved_write_frame(s_format_context, &pkt);
+		auto wait_start = std::chrono::steady_clock::now();
+		s_queue_cond.wait(lk, [] { return s_frame_queue.size() < FRAME_QUEUE_SIZE; });
+		s_blocked_us += std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - wait_start).count();
+	}
 
-		// Handle delayed frames.
-		PreparePacket(&pkt);
-		error = avcodec_encode_video2(s_stream->codec, &pkt, nullptr, &got_packet);
+	std::vector<u8> buffer;
+	if (!s_buffer_pool.empty())
+	{
+		buffer = std::move(s_buffer_pool.back());
+		s_buffer_pool.pop_back();
 	}
-	if (error)
-		ERROR_LOG(VIDEO, "Error while encoding video: %d", error);
+	lk.unlock();
+
+	size_t size = avpicture_get_size(s_pix_fmt, width, height);
+	buffer.resize(size);
+	std::memcpy(buffer.data(), data, size);
+
+	lk.lock();
+	s_frame_queue.push_back({std::move(buffer), width, height, pts});
+	s_frames_queued++;
+	s_max_queue_depth = std::max(s_max_queue_depth, s_frame_queue.size());
+	lk.unlock();
+	s_queue_cond.notify_all();
 }
 
 void AVIDump::Stop()
 {
+	{
+		std::lock_guard<std::mutex> lk(s_queue_lock);
+		s_encoder_stop = true;
+	}
+	s_queue_cond.notify_all();
+	if (s_encoder_thread.joinable())
+		s_encoder_thread.join();
+
 	av_write_trailer(s_format_context);
 	CloseFile();
-	NOTICE_LOG(VIDEO, "Stopping frame dump");
+	NOTICE_LOG(VIDEO, "Stopping frame dump: %" PRIu64 " frames encoded, %" PRIu64 " dropped, "
+	           "waited %" PRIu64 " ms for the encoder, queue peaked at %zu frames",
+	           s_frames_queued, s_frames_dropped, s_blocked_us / 1000, s_max_queue_depth);
 }
 
 void AVIDump::CloseFile()
@@ -266,6 +400,8 @@ void AVIDump::CloseFile()
 		sws_freeContext(s_sws_context);
 		s_sws_context = nullptr;
 	}
+
+	s_buffer_pool.clear();
 }
 
 void AVIDump::DoState()
@@ -11,6 +11,7 @@ class AVIDump
 private:
 	static bool CreateFile();
 	static void CloseFile();
+	static void EncoderThread();
 
 public:
 	enum class DumpFormat
@@ -24,6 +24,7 @@
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
@@ -48,10 +49,27 @@ static const float s_gammaLUT[] =
 	1.0f
 };
 
+// Registers read by the pixel and tessellation shader UID generators.
+static bool AffectsShaderUid(u32 address)
+{
+	return address == BPMEM_GENMODE
+		|| (address >= BPMEM_IND_CMD && address < BPMEM_IND_CMD + 16)
+		|| (address >= BPMEM_IREF && address < BPMEM_TREF + 8)
+		|| address == BPMEM_ZMODE
+		|| address == BPMEM_ZCOMPARE
+		|| (address >= BPMEM_TEV_COLOR_ENV && address < BPMEM_TEV_COLOR_ENV + 32)
+		|| address == BPMEM_FOGRANGE
+		|| address == BPMEM_FOGPARAM3
+		|| address == BPMEM_ALPHACOMPARE
+		|| address == BPMEM_ZTEX2
+		|| (address >= BPMEM_TEV_KSEL && address < BPMEM_TEV_KSEL + 8);
+}
+
 void BPInit()
 {
 	memset(&bpmem, 0, sizeof(bpmem));
 	bpmem.bpMask = 0xFFFFFF;
+	SetShaderUidDirty(SHADER_UID_DIRTY_ALL);
 
 	mapTexAddress = 0;
 	numWrites = 0;
@@ -121,6 +139,9 @@ void BPWritten(const BPCmd& bp)
 
 	((u32*)&bpmem)[bp.address] = bp.newvalue;
 
+	if (AffectsShaderUid(bp.address))
+		SetShaderUidDirty(SHADER_UID_DIRTY_PIXEL | SHADER_UID_DIRTY_TESSELLATION);
+
 	switch (bp.address)
 	{
 	case BPMEM_GENMODE: // Set the Generation Mode
@@ -316,6 +337,7 @@ void BPWritten(const BPCmd& bp)
 			addr = addr & 0x01FFFFFF;
 
 		Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
+		TextureCacheBase::InvalidateStageBindings();
 
 		if (g_bRecordFifoData)
 			FifoRecorder::GetInstance().UseMemory(addr, tlutXferCount, MemoryUpdate::TMEM);
@@ -435,6 +457,8 @@ void BPWritten(const BPCmd& bp)
 		return;
 	case BPMEM_TEXINVALIDATE:
 		// TODO: Needs some restructuring in TextureCacheBase.
+		// Games issue this after modifying texture memory, so stop reusing the previous loads.
+		TextureCacheBase::InvalidateStageBindings();
 		return;
 
 	case BPMEM_ZCOMPARE:      // Set the Z-Compare and EFB pixel format
@@ -532,6 +556,8 @@ void BPWritten(const BPCmd& bp)
 
 			if (g_bRecordFifoData)
 				FifoRecorder::GetInstance().UseMemory(src_addr, bytes_read, MemoryUpdate::TMEM);
+
+			TextureCacheBase::InvalidateStageBindings();
 		}
 		return;
 
@@ -8,6 +8,7 @@
 #include "Common/CommonTypes.h"
 #include "VideoCommon/GeometryShaderGen.h"
 #include "VideoCommon/LightingShaderGen.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -27,7 +28,9 @@ static const char* primitives_d3d[] =
 	"triangle"
 };
 
-void GetGeometryShaderUid(GeometryShaderUid& out, u32 primitive_type, const XFMemory &xfr, const u32 components)
+static ShaderUidCache<GeometryShaderUid, 4> s_uid_cache(SHADER_UID_DIRTY_GEOMETRY);
+
+static void CalculateGeometryShaderUid(GeometryShaderUid& out, u32 primitive_type, const XFMemory &xfr, const u32 components)
 {
 	out.ClearUID();
 	geometry_shader_uid_data& uid_data = out.GetUidData<geometry_shader_uid_data>();
@@ -41,6 +44,24 @@ void GetGeometryShaderUid(GeometryShaderUid& out, u32 primitive_type, const XFMe
 	out.CalculateUIDHash();
 }
 
+void GetGeometryShaderUid(GeometryShaderUid& out, u32 primitive_type, const XFMemory &xfr, const u32 components)
+{
+	if (&xfr != &xfmem)
+	{
+		CalculateGeometryShaderUid(out, primitive_type, xfr, components);
+		return;
+	}
+	u64 key = components | (static_cast<u64>(primitive_type) << 32);
+	if (const GeometryShaderUid* uid = s_uid_cache.Find(key))
+	{
+		out = *uid;
+		INCSTAT(stats.thisFrame.numShaderUidsReused);
+		return;
+	}
+	CalculateGeometryShaderUid(out, primitive_type, xfr, components);
+	s_uid_cache.Insert(key, out);
+}
+
 template<API_TYPE ApiType>
 inline void EmitVertex(ShaderCode& out, const geometry_shader_uid_data& uid_data, const char* vertex, bool first_vertex)
 {
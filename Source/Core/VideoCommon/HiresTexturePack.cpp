@@ -0,0 +1,298 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Common/Hash.h"
+#include "Common/StringUtil.h"
+#include "Common/Logging/Log.h"
+
+#include "VideoCommon/HiresTexturePack.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/TextureUtil.h"
+
+// Larger textures would overflow the size calculation, and no backend can create them anyway.
+static const u32 MAX_TEXTURE_DIMENSION = 16384;
+
+// Checks that an entry describes a texture the upload path can read entirely from its data.
+static bool IsValidEntry(const HiresTexturePack::Entry& entry)
+{
+	const PC_TexFormat format = static_cast<PC_TexFormat>(entry.format);
+	if (format != PC_TEX_FMT_RGBA32 && format != PC_TEX_FMT_DXT1 &&
+		format != PC_TEX_FMT_DXT3 && format != PC_TEX_FMT_DXT5)
+		return false;
+
+	if (entry.width == 0 || entry.height == 0 ||
+		entry.width > MAX_TEXTURE_DIMENSION || entry.height > MAX_TEXTURE_DIMENSION)
+		return false;
+
+	u32 max_levels = 1;
+	while ((std::max(entry.width, entry.height) >> max_levels) != 0)
+		max_levels++;
+	if (entry.levels == 0 || entry.levels > max_levels)
+		return false;
+
+	// The normal map is uploaded with the same levels as the colour texture.
+	if (entry.nrm_levels != 0 && entry.nrm_levels < entry.levels)
+		return false;
+
+	u64 total_size = 0;
+	for (u32 level = 0; level < entry.levels; level++)
+	{
+		total_size += TextureUtil::GetTextureSizeInBytes(
+			TextureUtil::CalculateLevelSize(entry.width, level),
+			TextureUtil::CalculateLevelSize(entry.height, level), format);
+	}
+	if (entry.nrm_levels != 0)
+		total_size *= 2;
+	return total_size <= entry.data_size;
+}
+
+HiresTexturePack::HiresTexturePack()
+{
+}
+
+HiresTexturePack::~HiresTexturePack()
+{
+	Close();
+}
+
+u64 HiresTexturePack::HashName(const std::string& name)
+{
+	return GetXXH3Hash64(reinterpret_cast<const u8*>(name.data()), static_cast<u32>(name.size()), 0);
+}
+
+bool HiresTexturePack::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFile(UTF8ToTStr(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	m_base = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!m_base)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_file_handle = file;
+	m_mapping_handle = mapping;
+	m_size = size.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	void* base = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+		base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping keeps its own reference to the file.
+	close(fd);
+	if (base == MAP_FAILED)
+		return false;
+	// Lookups jump around the index and textures are read in one go, so
+	// readahead of neighbouring pages would mostly be wasted.
+	madvise(base, st.st_size, MADV_RANDOM);
+	m_base = static_cast<const u8*>(base);
+	m_size = st.st_size;
+#endif
+
+	m_header = reinterpret_cast<const Header*>(m_base);
+	if (m_size < sizeof(Header) || m_header->magic != MAGIC || m_header->version != VERSION ||
+		m_header->index_offset > m_size ||
+		(m_size - m_header->index_offset) / sizeof(Entry) < m_header->entry_count ||
+		m_header->names_offset > m_header->index_offset)
+	{
+		ERROR_LOG(VIDEO, "Custom texture pack %s is invalid", path.c_str());
+		Close();
+		return false;
+	}
+	m_index = reinterpret_cast<const Entry*>(m_base + m_header->index_offset);
+
+	for (u32 i = 0; i < m_header->entry_count; i++)
+	{
+		const Entry& entry = m_index[i];
+		if (entry.data_offset > m_header->names_offset ||
+			entry.data_size > m_header->names_offset - entry.data_offset ||
+			entry.name_offset >= m_header->index_offset - m_header->names_offset ||
+			!IsValidEntry(entry))
+		{
+			ERROR_LOG(VIDEO, "Custom texture pack %s has a corrupt entry %u", path.c_str(), i);
+			Close();
+			return false;
+		}
+	}
+	// The names block must end with a terminator so GetName never runs off the end.
+	if (m_header->entry_count && m_base[m_header->index_offset - 1] != 0)
+	{
+		ERROR_LOG(VIDEO, "Custom texture pack %s has a corrupt name table", path.c_str());
+		Close();
+		return false;
+	}
+
+	INFO_LOG(VIDEO, "Opened custom texture pack %s with %u textures", path.c_str(), m_header->entry_count);
+	return true;
+}
+
+void HiresTexturePack::Close()
+{
+	if (!m_base)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_base);
+	CloseHandle(m_mapping_handle);
+	CloseHandle(m_file_handle);
+	m_mapping_handle = nullptr;
+	m_file_handle = nullptr;
+#else
+	munmap(const_cast<u8*>(m_base), m_size);
+#endif
+	m_base = nullptr;
+	m_size = 0;
+	m_header = nullptr;
+	m_index = nullptr;
+}
+
+const char* HiresTexturePack::GetName(const Entry& entry) const
+{
+	return reinterpret_cast<const char*>(m_base + m_header->names_offset + entry.name_offset);
+}
+
+const HiresTexturePack::Entry* HiresTexturePack::Find(const std::string& name) const
+{
+	if (!m_base)
+		return nullptr;
+
+	u64 hash = HashName(name);
+	const Entry* end = m_index + m_header->entry_count;
+	const Entry* it = std::lower_bound(m_index, end, hash, [](const Entry& entry, u64 value)
+	{
+		return entry.name_hash < value;
+	});
+	for (; it != end && it->name_hash == hash; ++it)
+	{
+		if (name == GetName(*it))
+			return it;
+	}
+	return nullptr;
+}
+
+void HiresTexturePack::Advise(const Entry& entry, bool will_need) const
+{
+#ifdef _WIN32
+	if (will_need)
+	{
+		// Touch one byte per page; PrefetchVirtualMemory is not available before Windows 8.
+		volatile u8 sink = 0;
+		for (u64 offset = 0; offset < entry.data_size; offset += 4096)
+			sink += m_base[entry.data_offset + offset];
+	}
+#else
+	static const uintptr_t page_mask = ~(static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1);
+	uintptr_t start = reinterpret_cast<uintptr_t>(m_base + entry.data_offset);
+	uintptr_t end = start + entry.data_size;
+	uintptr_t aligned_start = start & page_mask;
+	if (!will_need)
+	{
+		// Only drop pages that belong to this entry alone.
+		if (aligned_start != start)
+			aligned_start += ~page_mask + 1;
+		end &= page_mask;
+		if (end <= aligned_start)
+			return;
+	}
+	madvise(reinterpret_cast<void*>(aligned_start), end - aligned_start, will_need ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
+
+void HiresTexturePack::Prefetch(const Entry& entry) const
+{
+	Advise(entry, true);
+}
+
+void HiresTexturePack::Release(const Entry& entry) const
+{
+	Advise(entry, false);
+}
+
+bool HiresTexturePackWriter::Open(const std::string& path)
+{
+	m_entries.clear();
+	m_names.clear();
+	if (!m_file.Open(path, "wb"))
+		return false;
+
+	HiresTexturePack::Header header = {};
+	return m_file.WriteBytes(&header, sizeof(header));
+}
+
+bool HiresTexturePackWriter::Align(u64 alignment)
+{
+	static const u8 zeroes[16] = {};
+	u64 padding = (alignment - m_file.Tell() % alignment) % alignment;
+	return m_file.WriteBytes(zeroes, padding);
+}
+
+bool HiresTexturePackWriter::Add(const std::string& name, HiresTexturePack::Entry entry, const u8* data)
+{
+	if (!Align(16))
+		return false;
+
+	entry.name_hash = HiresTexturePack::HashName(name);
+	entry.data_offset = m_file.Tell();
+	entry.name_offset = static_cast<u32>(m_names.size());
+	entry.padding = 0;
+	if (!m_file.WriteBytes(data, entry.data_size))
+		return false;
+
+	m_names.append(name.c_str(), name.size() + 1);
+	m_entries.push_back(entry);
+	return true;
+}
+
+bool HiresTexturePackWriter::Finish(u32 flags)
+{
+	std::sort(m_entries.begin(), m_entries.end(), [](const HiresTexturePack::Entry& a, const HiresTexturePack::Entry& b)
+	{
+		return a.name_hash < b.name_hash;
+	});
+
+	HiresTexturePack::Header header;
+	header.magic = HiresTexturePack::MAGIC;
+	header.version = HiresTexturePack::VERSION;
+	header.flags = flags;
+	header.entry_count = static_cast<u32>(m_entries.size());
+	header.names_offset = m_file.Tell();
+	if (!m_file.WriteBytes(m_names.data(), m_names.size()) || !Align(8))
+		return false;
+	header.index_offset = m_file.Tell();
+	if (!m_file.WriteArray(m_entries.data(), m_entries.size()))
+		return false;
+
+	bool success = m_file.Seek(0, SEEK_SET) && m_file.WriteBytes(&header, sizeof(header));
+	return m_file.Close() && success;
+}
@@ -0,0 +1,115 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/NonCopyable.h"
+
+// A single file holding the custom textures of a game, already decoded into the
+// layout HiresTexture hands to the backends (RGBA8 or DXTn, all levels packed).
+//
+// Layout (little endian):
+//   Header
+//   texture data, every blob aligned to 16 bytes
+//   names, zero terminated
+//   Entry[entry_count], sorted by name_hash
+//
+// The file is memory mapped, so a lookup is a binary search over the index and
+// only the pages of the textures that are actually used get read from disk.
+class HiresTexturePack : NonCopyable
+{
+public:
+	enum : u32
+	{
+		MAGIC = 0x4B505444, // "DTPK"
+		VERSION = 1,
+	};
+
+	enum : u32
+	{
+		FLAG_NATIVE_NAMES = 1, // contains <GAMEID>_<hash>_<format> names
+		FLAG_NEW_NAMES = 2,    // contains tex1_ names
+	};
+
+	struct Header
+	{
+		u32 magic;
+		u32 version;
+		u32 flags;
+		u32 entry_count;
+		u64 names_offset;
+		u64 index_offset;
+	};
+
+	struct Entry
+	{
+		u64 name_hash;
+		u64 data_offset;
+		u64 data_size;
+		u32 name_offset;
+		u32 width;
+		u32 height;
+		u8 format;
+		u8 levels;
+		u8 nrm_levels;
+		u8 padding;
+	};
+
+	static_assert(sizeof(Header) == 32, "Header layout must not change");
+	static_assert(sizeof(Entry) == 40, "Entry layout must not change");
+
+	HiresTexturePack();
+	~HiresTexturePack();
+
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const { return m_base != nullptr; }
+
+	u32 GetFlags() const { return m_header->flags; }
+	u32 GetEntryCount() const { return m_header->entry_count; }
+
+	const Entry* Find(const std::string& name) const;
+	const Entry& GetEntry(u32 index) const { return m_index[index]; }
+	const char* GetName(const Entry& entry) const;
+	const u8* GetData(const Entry& entry) const { return m_base + entry.data_offset; }
+
+	// Residency hints for the pages backing an entry.
+	void Prefetch(const Entry& entry) const;
+	void Release(const Entry& entry) const;
+
+	static u64 HashName(const std::string& name);
+
+private:
+	void Advise(const Entry& entry, bool will_need) const;
+
+	const u8* m_base = nullptr;
+	u64 m_size = 0;
+	const Header* m_header = nullptr;
+	const Entry* m_index = nullptr;
+#ifdef _WIN32
+	void* m_file_handle = nullptr;
+	void* m_mapping_handle = nullptr;
+#endif
+};
+
+// Streams textures into a new pack; the index is written by Finish().
+class HiresTexturePackWriter : NonCopyable
+{
+public:
+	bool Open(const std::string& path);
+	bool Add(const std::string& name, HiresTexturePack::Entry entry, const u8* data);
+	bool Finish(u32 flags);
+
+private:
+	bool Align(u64 alignment);
+
+	File::IOFile m_file;
+	std::vector<HiresTexturePack::Entry> m_entries;
+	std::string m_names;
+};
@@ -4,11 +4,11 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
@@ -18,10 +18,10 @@
 #include "Common/CommonPaths.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
-#include "Common/Flag.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 #include "Common/Logging/Log.h"
 
@@ -50,24 +50,264 @@ struct HiresTextureCacheItem{
 typedef std::unordered_map<std::string, HiresTextureCacheItem> HiresTextureCache;
 static HiresTextureCache s_textureMap;
 
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
-static std::mutex s_textureCacheMutex;
-static Common::Flag s_textureCacheAbortLoading;
+static HiresTexturePack s_texturePack;
 
 static bool s_check_native_format;
 static bool s_check_new_format;
 static std::atomic<size_t> size_sum;
 static size_t max_mem = 0;
-static std::thread s_prefetcher;
 
 static const std::string s_format_prefix = "tex1_";
+static const std::string s_pack_extension = ".dtp";
+
+// Textures kept in memory for reuse. The map is split into shards so a lookup only
+// contends with loaders publishing into the same shard, never with the whole cache.
+// An entry without a texture is a claim by a thread that is currently loading it.
+// Textures that come from the pack only account for the pages of the mapping they touch.
+class HiresTextureCacheMap
+{
+public:
+	// Returns the texture, waiting for it if another thread is loading it. When nobody
+	// has it yet, the caller gets the claim (claimed = true) and must Publish or Abandon.
+	std::shared_ptr<HiresTexture> Acquire(const std::string& name, bool& claimed)
+	{
+		Shard& shard = GetShard(name);
+		std::unique_lock<std::mutex> lk(shard.lock);
+		claimed = false;
+		while (true)
+		{
+			auto iter = shard.map.find(name);
+			if (iter == shard.map.end())
+			{
+				shard.map.emplace(name, Entry());
+				claimed = true;
+				return nullptr;
+			}
+			if (iter->second.texture)
+			{
+				iter->second.last_used = ++m_clock;
+				return iter->second.texture;
+			}
+			shard.published.wait(lk);
+		}
+	}
+
+	// Claims a texture for prefetching, fails if it is cached or already being loaded.
+	bool Claim(const std::string& name)
+	{
+		Shard& shard = GetShard(name);
+		std::lock_guard<std::mutex> lk(shard.lock);
+		return shard.map.emplace(name, Entry()).second;
+	}
+
+	// Prefetched textures count as least recently used, so they are the first to go.
+	void Publish(const std::string& name, const std::shared_ptr<HiresTexture>& texture, bool prefetched)
+	{
+		Shard& shard = GetShard(name);
+		{
+			std::lock_guard<std::mutex> lk(shard.lock);
+			Entry& entry = shard.map[name];
+			entry.texture = texture;
+			entry.last_used = prefetched ? 0 : ++m_clock;
+			size_sum.fetch_add(texture->m_cached_data_size);
+		}
+		shard.published.notify_all();
+		if (!prefetched)
+			Evict(max_mem);
+	}
+
+	void Abandon(const std::string& name)
+	{
+		Shard& shard = GetShard(name);
+		{
+			std::lock_guard<std::mutex> lk(shard.lock);
+			shard.map.erase(name);
+		}
+		shard.published.notify_all();
+	}
+
+	template <typename Predicate>
+	void EraseIf(Predicate pred)
+	{
+		for (Shard& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lk(shard.lock);
+			for (auto iter = shard.map.begin(); iter != shard.map.end();)
+			{
+				if (iter->second.texture && pred(iter->first, *iter->second.texture))
+					iter = Erase(shard, iter);
+				else
+					++iter;
+			}
+		}
+	}
+
+	void Clear()
+	{
+		EraseIf([](const std::string&, const HiresTexture&) { return true; });
+	}
+
+	// Drops the least recently used textures until the cache fits in the budget again,
+	// with some headroom so that a full cache doesn't evict on every miss.
+	void Evict(size_t budget)
+	{
+		if (size_sum.load() <= budget)
+			return;
+
+		std::lock_guard<std::mutex> evict_lock(m_evict_lock);
+		std::vector<std::pair<u64, std::string>> candidates;
+		for (Shard& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lk(shard.lock);
+			for (const auto& item : shard.map)
+			{
+				if (item.second.texture)
+					candidates.emplace_back(item.second.last_used, item.first);
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+
+		size_t target = budget - budget / 8;
+		for (const auto& candidate : candidates)
+		{
+			if (size_sum.load() <= target)
+				break;
+			Shard& shard = GetShard(candidate.second);
+			std::lock_guard<std::mutex> lk(shard.lock);
+			auto iter = shard.map.find(candidate.second);
+			// Skip textures that were used again in the meantime
+			if (iter != shard.map.end() && iter->second.texture && iter->second.last_used == candidate.first)
+				Erase(shard, iter);
+		}
+	}
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<HiresTexture> texture;
+		u64 last_used = 0;
+	};
+
+	struct Shard
+	{
+		std::mutex lock;
+		std::condition_variable published;
+		std::unordered_map<std::string, Entry> map;
+	};
+
+	enum { NUM_SHARDS = 16 };
+
+	Shard& GetShard(const std::string& name)
+	{
+		return m_shards[std::hash<std::string>()(name) % NUM_SHARDS];
+	}
+
+	std::unordered_map<std::string, Entry>::iterator Erase(Shard& shard, std::unordered_map<std::string, Entry>::iterator iter)
+	{
+		const HiresTexture* texture = iter->second.texture.get();
+		if (texture->m_pack_entry)
+			s_texturePack.Release(*texture->m_pack_entry);
+		size_sum.fetch_sub(texture->m_cached_data_size);
+		return shard.map.erase(iter);
+	}
+
+	Shard m_shards[NUM_SHARDS];
+	std::atomic<u64> m_clock{ 0 };
+	std::mutex m_evict_lock;
+};
+
+static HiresTextureCacheMap s_textureCache;
+
+// Prefetches every custom texture of the game on the shared thread pool, several
+// decodes at a time. Textures requested by Search don't wait for their turn in
+// here: the requesting thread loads them itself, or waits for the worker that is
+// already busy with it.
+class HiresTextureLoader final : public Common::IWorker
+{
+public:
+	void Start(std::vector<std::string>&& names)
+	{
+		m_names = std::move(names);
+		m_next.store(0);
+		m_remaining.store(m_names.size());
+		m_budget_reached.store(false);
+		m_start_time = Common::Timer::GetTimeMs();
+		m_abort.store(false);
+		for (size_t i = 0; i < m_names.size(); i++)
+			Common::ThreadPool::NotifyWorkPending();
+	}
+
+	// Waits for the workers to finish the textures they are currently loading.
+	void Stop()
+	{
+		m_abort.store(true);
+		u32 loopcount = 0;
+		while (m_active.load() > 0)
+			Common::cYield(loopcount++);
+		m_names.clear();
+	}
+
+	bool NextTask() override
+	{
+		m_active.fetch_add(1);
+		bool worked = !m_abort.load() && LoadNext();
+		m_active.fetch_sub(1);
+		return worked;
+	}
+
+private:
+	bool LoadNext()
+	{
+		size_t index = m_next.fetch_add(1);
+		if (index >= m_names.size())
+			return false;
+
+		// Prefetching never evicts, textures that are in use have priority
+		if (size_sum.load() > max_mem)
+		{
+			m_next.store(m_names.size());
+			if (!m_budget_reached.exchange(true))
+				OSD::AddMessage(StringFromFormat("Custom Textures prefetching stopped after %.1f MB, memory budget reached", size_sum / (1024.0 * 1024.0)), 10000);
+			return false;
+		}
+
+		const std::string& name = m_names[index];
+		if (s_textureCache.Claim(name))
+		{
+			std::shared_ptr<HiresTexture> texture(HiresTexture::LoadCached(name));
+			if (texture)
+				s_textureCache.Publish(name, texture, true);
+			else
+				s_textureCache.Abandon(name);
+		}
+
+		if (m_remaining.fetch_sub(1) == 1)
+		{
+			u32 stoptime = Common::Timer::GetTimeMs();
+			OSD::AddMessage(StringFromFormat("Custom Textures loaded, %.1f MB in %.1f s", size_sum / (1024.0 * 1024.0), (stoptime - m_start_time) / 1000.0), 10000);
+		}
+		return true;
+	}
+
+	std::vector<std::string> m_names;
+	std::atomic<size_t> m_next{ 0 };
+	std::atomic<size_t> m_remaining{ 0 };
+	std::atomic<s32> m_active{ 0 };
+	std::atomic<bool> m_abort{ true };
+	std::atomic<bool> m_budget_reached{ false };
+	u32 m_start_time = 0;
+};
+
+static HiresTextureLoader s_loader;
+
 HiresTexture::HiresTexture() : 
 	m_format(PC_TEX_FMT_NONE),
 	m_height(0),
 	m_levels(0),
 	m_nrm_levels(0),
 	m_cached_data(nullptr),
-	m_cached_data_size(0) 
+	m_cached_data_size(0),
+	m_pack_entry(nullptr)
 {
 }
 
@@ -78,19 +318,18 @@ void HiresTexture::Init()
 	size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
 	// keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
 	max_mem = (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+	Common::ThreadPool::RegisterWorker(&s_loader);
 	Update();
 }
 
 void HiresTexture::Shutdown()
 {
-	if (s_prefetcher.joinable())
-	{
-		s_textureCacheAbortLoading.Set();
-		s_prefetcher.join();
-	}
+	s_loader.Stop();
+	Common::ThreadPool::UnregisterWorker(&s_loader);
 
 	s_textureMap.clear();
-	s_textureCache.clear();
+	s_textureCache.Clear();
+	s_texturePack.Close();
 }
 
 std::string HiresTexture::GetTextureDirectory(const std::string& game_id)
@@ -104,35 +343,20 @@ std::string HiresTexture::GetTextureDirectory(const std::string& game_id)
 	return texture_directory;
 }
 
-void HiresTexture::Update()
+std::string HiresTexture::GetTexturePackPath(const std::string& game_id)
 {
-	s_check_native_format = false;
-	s_check_new_format = false;
-
-	if (s_prefetcher.joinable())
-	{
-		s_textureCacheAbortLoading.Set();
-		s_prefetcher.join();
-	}
+	const std::string pack_path = File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id + s_pack_extension;
 
-	if (!g_ActiveConfig.bHiresTextures)
-	{
-		s_textureMap.clear();
-		s_textureCache.clear();
-		size_sum.store(0);
-		return;
-	}
+	// Same fallback to the region-free ID as for directories
+	if (!File::Exists(pack_path))
+		return File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id.substr(0, 3) + s_pack_extension;
 
-	if (!g_ActiveConfig.bCacheHiresTextures)
-	{
-		s_textureCache.clear();
-		size_sum.store(0);
-	}
-	
-	s_textureMap.clear();
-	const std::string& game_id = SConfig::GetInstance().m_strUniqueID;
-	const std::string texture_directory = GetTextureDirectory(game_id);
+	return pack_path;
+}
 
+static void ScanTextureDirectory(const std::string& texture_directory, const std::string& game_id,
+	HiresTextureCache& texture_map, bool& check_native_format, bool& check_new_format)
+{
 	std::string ddscode(".dds");
 	std::string cddscode(".DDS");
 	std::vector<std::string> Extensions = {
@@ -152,11 +376,11 @@ void HiresTexture::Update()
 		SplitPath(filenames[i], nullptr, &FileName, &Extension);
 		if (FileName.substr(0, code.length()) == code)
 		{
-			s_check_native_format = true;
+			check_native_format = true;
 		}
 		else if (FileName.substr(0, s_format_prefix.length()) == s_format_prefix)
 		{
-			s_check_new_format = true;
+			check_new_format = true;
 		}
 		else
 		{
@@ -178,9 +402,9 @@ void HiresTexture::Update()
 			sscanf(miplevel.substr(3, std::string::npos).c_str(), "%i", &level);
 			FileName = FileName.substr(0, idx);
 		}
-		HiresTextureCache::iterator iter = s_textureMap.find(FileName);
+		HiresTextureCache::iterator iter = texture_map.find(FileName);
 		u32 min_item_size = level + 1;
-		if (iter == s_textureMap.end())
+		if (iter == texture_map.end())
 		{
 			HiresTextureCacheItem item(min_item_size);
 			if (is_normal_map)
@@ -189,7 +413,7 @@ void HiresTexture::Update()
 			}
 			std::vector<hires_mip_level> &dst = is_normal_map ? item.normal_map : item.color_map;
 			dst[level] = mip_level_detail;
-			s_textureMap.emplace(FileName, item);
+			texture_map.emplace(FileName, item);
 		}
 		else
 		{
@@ -201,70 +425,145 @@ void HiresTexture::Update()
 			dst[level] = mip_level_detail;
 		}
 	}
+}
+
+void HiresTexture::Update()
+{
+	s_check_native_format = false;
+	s_check_new_format = false;
+
+	s_loader.Stop();
 
-	if (g_ActiveConfig.bCacheHiresTextures && s_textureMap.size() > 0)
+	// Cached textures may point into the old mapping
+	s_textureCache.EraseIf([](const std::string&, const HiresTexture& texture)
+	{
+		return texture.m_pack_entry != nullptr;
+	});
+	s_texturePack.Close();
+
+	if (!g_ActiveConfig.bHiresTextures)
+	{
+		s_textureMap.clear();
+		s_textureCache.Clear();
+		return;
+	}
+
+	if (!g_ActiveConfig.bCacheHiresTextures)
+	{
+		s_textureCache.Clear();
+	}
+	
+	s_textureMap.clear();
+	const std::string& game_id = SConfig::GetInstance().m_strUniqueID;
+
+	// A texture pack replaces the loose files, so a large pack doesn't require walking the directory.
+	if (s_texturePack.Open(GetTexturePackPath(game_id)))
+	{
+		s_check_native_format = (s_texturePack.GetFlags() & HiresTexturePack::FLAG_NATIVE_NAMES) != 0;
+		s_check_new_format = (s_texturePack.GetFlags() & HiresTexturePack::FLAG_NEW_NAMES) != 0;
+	}
+	else
+	{
+		ScanTextureDirectory(GetTextureDirectory(game_id), game_id, s_textureMap, s_check_native_format, s_check_new_format);
+	}
+
+	if (g_ActiveConfig.bCacheHiresTextures && (s_textureMap.size() > 0 || s_texturePack.IsOpen()))
 	{
 		// remove cached but deleted textures
-		auto iter = s_textureCache.begin();
-		while (iter != s_textureCache.end())
+		s_textureCache.EraseIf([](const std::string& name, const HiresTexture&)
 		{
-			if (s_textureMap.find(iter->first) == s_textureMap.end())
-			{
-				size_sum.fetch_sub(iter->second->m_cached_data_size);
-				iter = s_textureCache.erase(iter);
-			}
-			else
-			{
-				iter++;
-			}
+			return s_textureMap.find(name) == s_textureMap.end();
+		});
+
+		std::vector<std::string> names;
+		if (s_texturePack.IsOpen())
+		{
+			names.reserve(s_texturePack.GetEntryCount());
+			for (u32 i = 0; i < s_texturePack.GetEntryCount(); i++)
+				names.emplace_back(s_texturePack.GetName(s_texturePack.GetEntry(i)));
+		}
+		else
+		{
+			names.reserve(s_textureMap.size());
+			for (const auto& entry : s_textureMap)
+				names.push_back(entry.first);
 		}
-		s_textureCacheAbortLoading.Clear();
-		s_prefetcher = std::thread(Prefetch);
+		s_loader.Start(std::move(names));
 	}
 }
 
-void HiresTexture::Prefetch()
+HiresTexture* HiresTexture::LoadFromPack(const HiresTexturePack::Entry& entry)
 {
-	Common::SetCurrentThreadName("Prefetcher");
+	HiresTexture* ret = new HiresTexture();
+	ret->m_format = static_cast<PC_TexFormat>(entry.format);
+	ret->m_width = entry.width;
+	ret->m_height = entry.height;
+	ret->m_levels = entry.levels;
+	ret->m_nrm_levels = g_ActiveConfig.HiresMaterialMapsEnabled() ? entry.nrm_levels : 0;
+	ret->m_cached_data_size = entry.data_size;
+	ret->m_pack_entry = &entry;
+	return ret;
+}
 
-	u32 starttime = Common::Timer::GetTimeMs();
-	for (const auto& entry : s_textureMap)
+HiresTexture* HiresTexture::LoadCached(const std::string& basename)
+{
+	const HiresTexturePack::Entry* pack_entry = s_texturePack.Find(basename);
+	if (pack_entry)
+	{
+		s_texturePack.Prefetch(*pack_entry);
+		return LoadFromPack(*pack_entry);
+	}
+	return Load(basename, [](size_t requested_size)
 	{
-		const std::string& base_filename = entry.first;
+		return new u8[requested_size];
+	}, true);
+}
 
-		std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+bool HiresTexture::BuildPack(const std::string& game_id, const std::string& texture_directory, const std::string& pack_path)
+{
+	HiresTextureCache texture_map;
+	bool has_native_names = false;
+	bool has_new_names = false;
+	ScanTextureDirectory(texture_directory, game_id, texture_map, has_native_names, has_new_names);
+	if (texture_map.empty())
+	{
+		ERROR_LOG(VIDEO, "No custom textures found in %s", texture_directory.c_str());
+		return false;
+	}
 
-		auto iter = s_textureCache.find(base_filename);
-		if (iter == s_textureCache.end())
-		{
-			lk.unlock();
-			HiresTexture* ptr = Load(base_filename, [](size_t requested_size)
-			{
-				return new u8[requested_size];
-			}, true);
-			lk.lock();
-			if (ptr != nullptr)
-			{
-				size_sum.fetch_add(ptr->m_cached_data_size);
-				iter = s_textureCache.insert(iter, std::make_pair(base_filename, std::shared_ptr<HiresTexture>(ptr)));
-			}
-		}
+	HiresTexturePackWriter writer;
+	if (!writer.Open(pack_path))
+	{
+		ERROR_LOG(VIDEO, "Failed to create custom texture pack %s", pack_path.c_str());
+		return false;
+	}
 
-		if (s_textureCacheAbortLoading.IsSet())
+	for (const auto& item : texture_map)
+	{
+		std::unique_ptr<HiresTexture> texture(LoadItem(item.second, [](size_t requested_size)
 		{
-			return;
-		}
+			return new u8[requested_size];
+		}, true, true));
+		if (!texture)
+			continue;
 
-		if (size_sum.load() > max_mem)
+		HiresTexturePack::Entry entry = {};
+		entry.data_size = texture->m_cached_data_size;
+		entry.width = texture->m_width;
+		entry.height = texture->m_height;
+		entry.format = static_cast<u8>(texture->m_format);
+		entry.levels = static_cast<u8>(texture->m_levels);
+		entry.nrm_levels = static_cast<u8>(texture->m_nrm_levels);
+		if (!writer.Add(item.first, entry, texture->m_cached_data.get()))
 		{
-			g_Config.bCacheHiresTextures = false;
-
-			OSD::AddMessage(StringFromFormat("Custom Textures prefetching after %.1f MB aborted, not enough RAM available", size_sum / (1024.0 * 1024.0)), 10000);
-			return;
+			ERROR_LOG(VIDEO, "Failed to write custom texture pack %s", pack_path.c_str());
+			return false;
 		}
 	}
-	u32 stoptime = Common::Timer::GetTimeMs();
-	OSD::AddMessage(StringFromFormat("Custom Textures loaded, %.1f MB in %.1f s", size_sum / (1024.0 * 1024.0), (stoptime - starttime) / 1000.0), 10000);
+
+	u32 flags = (has_native_names ? HiresTexturePack::FLAG_NATIVE_NAMES : 0) |
+		(has_new_names ? HiresTexturePack::FLAG_NEW_NAMES : 0);
+	return writer.Finish(flags);
 }
 
 std::string HiresTexture::GenBaseName(
@@ -294,6 +593,11 @@ std::string HiresTexture::GenBaseName(
 			else
 				return name;
 		}
+		else if (s_texturePack.Find(name))
+		{
+			// Packs are read only, so there is nothing to convert
+			return name;
+		}
 	}
 	if (dump || s_check_new_format || convert)
 	{
@@ -332,16 +636,18 @@ std::string HiresTexture::GenBaseName(
 			tlut_size = 2 * (max + 1 - min);
 			tlut += 2 * min;
 		}
-		u64 tex_hash = XXH64(texture, texture_size);
+		u64 tex_hash = XXH64(texture, texture_size, 0);
 		u64 tlut_hash = 0;
 		if(tlut_size)
-			tlut_hash = XXH64(tlut, tlut_size);
+			tlut_hash = XXH64(tlut, tlut_size, 0);
 		std::string basename = s_format_prefix + StringFromFormat("%dx%d%s_%016" PRIx64, width, height, has_mipmaps ? "_m" : "", tex_hash);
 		std::string tlutname = tlut_size ? StringFromFormat("_%016" PRIx64, tlut_hash) : "";
 		std::string formatname = StringFromFormat("_%d", format);
 		std::string fullname = basename + tlutname + formatname;
 		if (convert)
 		{
+			// The loaders read the map while prefetching
+			s_loader.Stop();
 			// new texture
 			if (s_textureMap.find(fullname) == s_textureMap.end())
 			{
@@ -452,40 +758,53 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(
 	const std::string& basename,
 	std::function<u8*(size_t)> request_buffer_delegate)
 {
-	if (g_ActiveConfig.bCacheHiresTextures && size_sum.load() < max_mem)
+	if (g_ActiveConfig.bCacheHiresTextures)
 	{
-		std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+		// Most textures have no replacement, don't touch the cache for those
+		if (s_textureMap.find(basename) == s_textureMap.end() && !s_texturePack.Find(basename))
+			return nullptr;
 
-		auto iter = s_textureCache.find(basename);
-		if (iter != s_textureCache.end())
+		bool claimed;
+		std::shared_ptr<HiresTexture> ptr = s_textureCache.Acquire(basename, claimed);
+		if (claimed)
 		{
-			HiresTexture* current = iter->second.get();
-			u8* dst = request_buffer_delegate(current->m_cached_data_size);
-			memcpy(dst, current->m_cached_data.get(), current->m_cached_data_size);
-			return iter->second;
+			ptr.reset(LoadCached(basename));
+			if (ptr)
+				s_textureCache.Publish(basename, ptr, false);
+			else
+				s_textureCache.Abandon(basename);
 		}
-		lk.unlock();
-		std::shared_ptr<HiresTexture> ptr(Load(basename, [](size_t requested_size)
-		{
-			return new u8[requested_size];
-		}, true));
-		lk.lock();
 		if (ptr)
 		{
-			s_textureCache[basename] = ptr;
 			HiresTexture* current = ptr.get();
-			size_sum.fetch_add(current->m_cached_data_size);
 			u8* dst = request_buffer_delegate(current->m_cached_data_size);
-			memcpy(dst, current->m_cached_data.get(), current->m_cached_data_size);
+			memcpy(dst, current->GetCachedData(), current->m_cached_data_size);
 		}
 		return ptr;
 	}
 	else
 	{
+		const HiresTexturePack::Entry* pack_entry = s_texturePack.Find(basename);
+		if (pack_entry)
+		{
+			std::shared_ptr<HiresTexture> ptr(LoadFromPack(*pack_entry));
+			memcpy(request_buffer_delegate(ptr->m_cached_data_size), ptr->GetCachedData(), ptr->m_cached_data_size);
+			// Nothing keeps track of the pages, so don't let them pile up
+			s_texturePack.Release(*pack_entry);
+			ptr->m_pack_entry = nullptr;
+			return ptr;
+		}
 		return std::shared_ptr<HiresTexture> (Load(basename, request_buffer_delegate, false));
 	}
 }
 
+const u8* HiresTexture::GetCachedData() const
+{
+	if (m_pack_entry)
+		return s_texturePack.GetData(*m_pack_entry);
+	return m_cached_data.get();
+}
+
 HiresTexture* HiresTexture::Load(const std::string& basename,
 	std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult)
 {
@@ -498,7 +817,12 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
 	{
 		return nullptr;
 	}
-	HiresTextureCacheItem& current = iter->second;
+	return LoadItem(iter->second, request_buffer_delegate, cacheresult, g_ActiveConfig.HiresMaterialMapsEnabled());
+}
+
+HiresTexture* HiresTexture::LoadItem(const HiresTextureCacheItem& current,
+	std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult, bool load_normal_maps)
+{
 	if (current.color_map.size() == 0)
 	{
 		return nullptr;
@@ -515,13 +839,13 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
 	bool last_level_is_dds = false;
 	bool allocated_data = false;
 	bool mipmapsize_included = false;
-	bool nrm_posible = current.normal_map.size() == current.color_map.size() && g_ActiveConfig.HiresMaterialMapsEnabled();
+	bool nrm_posible = current.normal_map.size() == current.color_map.size() && load_normal_maps;
 	size_t remaining_buffer_size = 0;
 	size_t total_buffer_size = 0;
 	for (size_t level = 0; level < current.color_map.size(); level++)
 	{
 		ImageLoaderParams imgInfo;
-		hires_mip_level &item = current.color_map[level];
+		const hires_mip_level &item = current.color_map[level];
 		imgInfo.dst = nullptr;
 		imgInfo.Path = item.path.c_str();
 		if (nrm_posible)
@@ -666,7 +990,7 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
 		for (size_t level = 0; level < current.normal_map.size(); level++)
 		{
 			ImageLoaderParams imgInfo;
-			hires_mip_level &item = current.normal_map[level];
+			const hires_mip_level &item = current.normal_map[level];
 			imgInfo.dst = nullptr;
 			imgInfo.Path = item.path.c_str();
 			imgInfo.request_buffer_delegate = [&](size_t requiredsize, bool mipmapsincluded)
@@ -5,12 +5,16 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "VideoCommon/HiresTexturePack.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/VideoCommon.h"
 
+struct HiresTextureCacheItem;
+
 class HiresTexture
 {
 public:
@@ -30,15 +34,27 @@ public:
 		bool has_mipmaps,
 		bool dump = false);
 
+	// Decodes every texture in texture_directory into a single pack file
+	static bool BuildPack(const std::string& game_id, const std::string& texture_directory,
+		const std::string& pack_path);
+
 	~HiresTexture() {};
 	PC_TexFormat m_format;	
 	u32 m_width, m_height, m_levels, m_nrm_levels;
 	std::unique_ptr<u8> m_cached_data;
 	size_t m_cached_data_size;
+	// Set when the data lives in the memory mapped texture pack instead of m_cached_data
+	const HiresTexturePack::Entry* m_pack_entry;
+	const u8* GetCachedData() const;
 private:	
+	friend class HiresTextureLoader;
 	static HiresTexture* Load(const std::string& base_filename,
 		std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult);
-	static void Prefetch();
+	static HiresTexture* LoadItem(const HiresTextureCacheItem& item,
+		std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult, bool load_normal_maps);
+	static HiresTexture* LoadFromPack(const HiresTexturePack::Entry& entry);
+	static HiresTexture* LoadCached(const std::string& basename);
 	HiresTexture();
 	static std::string GetTextureDirectory(const std::string& game_id);
+	static std::string GetTexturePackPath(const std::string& game_id);
 };
\ No newline at end of file
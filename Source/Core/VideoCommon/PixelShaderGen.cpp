@@ -18,6 +18,7 @@
 
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/XFMemory.h"  // for texture projection mode
 #include "VideoCommon/VideoConfig.h"
@@ -352,7 +353,7 @@ float3 perturb_normal( float3 N, float3 P, float2 texcoord , float3 map)
 
 // FIXME: Some of the video card's capabilities (BBox support, EarlyZ support, dstAlpha support) leak
 //        into this UID; This is really unhelpful if these UIDs ever move from one machine to another.
-void GetPixelShaderUID(PixelShaderUid& out, PIXEL_SHADER_RENDER_MODE render_mode, u32 components, const XFMemory &xfr, const BPMemory &bpm)
+static void CalculatePixelShaderUID(PixelShaderUid& out, PIXEL_SHADER_RENDER_MODE render_mode, u32 components, const XFMemory &xfr, const BPMemory &bpm)
 {
 	out.ClearUID();
 	pixel_shader_uid_data& uid_data = out.GetUidData<pixel_shader_uid_data>();
@@ -530,6 +531,28 @@ void GetPixelShaderUID(PixelShaderUid& out, PIXEL_SHADER_RENDER_MODE render_mode
 	out.CalculateUIDHash();
 }
 
+// One entry per render mode covers the default and alpha pass draws of a flush.
+static ShaderUidCache<PixelShaderUid, 4> s_uid_cache(SHADER_UID_DIRTY_PIXEL);
+
+void GetPixelShaderUID(PixelShaderUid& out, PIXEL_SHADER_RENDER_MODE render_mode, u32 components, const XFMemory &xfr, const BPMemory &bpm)
+{
+	// Shadow copies used by the shader precompiler have no dirty tracking.
+	if (&bpm != &bpmem || &xfr != &xfmem)
+	{
+		CalculatePixelShaderUID(out, render_mode, components, xfr, bpm);
+		return;
+	}
+	u64 key = components | (static_cast<u64>(render_mode) << 32) | (static_cast<u64>(BoundingBox::active) << 34);
+	if (const PixelShaderUid* uid = s_uid_cache.Find(key))
+	{
+		out = *uid;
+		INCSTAT(stats.thisFrame.numShaderUidsReused);
+		return;
+	}
+	CalculatePixelShaderUID(out, render_mode, components, xfr, bpm);
+	s_uid_cache.Insert(key, out);
+}
+
 static char text[PIXELSHADERGEN_BUFFERSIZE];
 
 template<API_TYPE ApiType>
@@ -402,7 +402,10 @@ void Renderer::DrawDebugText()
 	}
 	final_cyan += Common::Profiler::ToString();
 	if (g_ActiveConfig.bOverlayStats)
+	{
 		final_cyan += Statistics::ToString();
+		final_cyan += Core::GetAudioStats();
+	}
 	if (g_ActiveConfig.bOverlayProjStats)
 		final_cyan += Statistics::ToStringProj();
 	//and then the text
@@ -0,0 +1,7 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/ShaderGenCommon.h"
+
+u32 g_shader_uid_dirty = SHADER_UID_DIRTY_ALL;
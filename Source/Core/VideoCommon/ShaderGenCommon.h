@@ -83,6 +83,72 @@ private:
 	std::size_t HASH;
 };
 
+// Groups of shader UIDs whose inputs were modified since the UIDs were last generated
+// from the live bpmem/xfmem. Set by the BP/XF write paths and by config updates.
+enum ShaderUidDirtyFlags : u32
+{
+	SHADER_UID_DIRTY_PIXEL = 1 << 0,
+	SHADER_UID_DIRTY_VERTEX = 1 << 1,
+	SHADER_UID_DIRTY_GEOMETRY = 1 << 2,
+	SHADER_UID_DIRTY_TESSELLATION = 1 << 3,
+	SHADER_UID_DIRTY_ALL = (1 << 4) - 1,
+};
+
+extern u32 g_shader_uid_dirty;
+
+inline void SetShaderUidDirty(u32 flags)
+{
+	g_shader_uid_dirty |= flags;
+}
+
+/**
+* Remembers the last UIDs generated from the live bpmem/xfmem, keyed on the generator
+* arguments that do not come from the registers (render mode, components, ...).
+* Entries stay valid until the dirty flag of the cache is set again.
+* Only used on the GPU thread, which is the only writer of bpmem/xfmem.
+*/
+template<class Uid, u32 num_entries>
+class ShaderUidCache
+{
+public:
+	explicit ShaderUidCache(u32 dirty_flag) : m_dirty_flag(dirty_flag) {}
+
+	const Uid* Find(u64 key)
+	{
+		if (g_shader_uid_dirty & m_dirty_flag)
+		{
+			g_shader_uid_dirty &= ~m_dirty_flag;
+			m_size = 0;
+			return nullptr;
+		}
+		for (u32 i = 0; i < m_size; i++)
+		{
+			if (m_entries[i].key == key)
+				return &m_entries[i].uid;
+		}
+		return nullptr;
+	}
+
+	void Insert(u64 key, const Uid& uid)
+	{
+		Entry& entry = m_entries[m_size < num_entries ? m_size++ : m_next++ % num_entries];
+		entry.key = key;
+		entry.uid = uid;
+	}
+
+private:
+	struct Entry
+	{
+		u64 key;
+		Uid uid;
+	};
+
+	Entry m_entries[num_entries];
+	u32 m_size = 0;
+	u32 m_next = 0;
+	const u32 m_dirty_flag;
+};
+
 class ShaderCode
 {
 public:
@@ -47,6 +47,8 @@ struct Statistics
 
 		int numPrimitiveJoins;
 		int numDrawCalls;
+		int numTextureLoadsSkipped;
+		int numShaderUidsReused;
 
 		int numDListsCalled;
 
@@ -8,6 +8,7 @@
 #include "VideoCommon/LightingShaderGen.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoConfig.h"
 static char text[TESSELLATIONSHADERGEN_BUFFERSIZE];
 
@@ -183,7 +184,9 @@ static inline void WriteStageUID(Tessellation_shader_uid_data& uid_data, int n,
 	}
 }
 
-void GetTessellationShaderUID(TessellationShaderUid& out, const XFMemory& xfr, const BPMemory& bpm, const u32 components)
+static ShaderUidCache<TessellationShaderUid, 2> s_uid_cache(SHADER_UID_DIRTY_TESSELLATION);
+
+static void CalculateTessellationShaderUID(TessellationShaderUid& out, const XFMemory& xfr, const BPMemory& bpm, const u32 components)
 {
 	Tessellation_shader_uid_data& uid_data = out.GetUidData<Tessellation_shader_uid_data>();
 	out.ClearUID();
@@ -262,6 +265,23 @@ void GetTessellationShaderUID(TessellationShaderUid& out, const XFMemory& xfr, c
 	out.CalculateUIDHash();
 }
 
+void GetTessellationShaderUID(TessellationShaderUid& out, const XFMemory& xfr, const BPMemory& bpm, const u32 components)
+{
+	if (&bpm != &bpmem || &xfr != &xfmem)
+	{
+		CalculateTessellationShaderUID(out, xfr, bpm, components);
+		return;
+	}
+	if (const TessellationShaderUid* uid = s_uid_cache.Find(components))
+	{
+		out = *uid;
+		INCSTAT(stats.thisFrame.numShaderUidsReused);
+		return;
+	}
+	CalculateTessellationShaderUID(out, xfr, bpm, components);
+	s_uid_cache.Insert(components, out);
+}
+
 template<API_TYPE ApiType>
 inline void WriteFetchDisplacement(ShaderCode& out, int n, const Tessellation_shader_uid_data &uid_data)
 {
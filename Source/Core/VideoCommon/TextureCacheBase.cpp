@@ -6,6 +6,7 @@
 #include <string>
 
 #include "Common/FileUtil.h"
+#include "Common/Hash.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
 
@@ -43,6 +44,8 @@ u32 TextureCacheBase::s_last_texture;
 
 
 TextureCacheBase::BackupConfig TextureCacheBase::backup_config;
+TextureCacheBase::StageBinding TextureCacheBase::s_stage_bindings[8];
+std::atomic<u64> TextureCacheBase::s_texture_generation;
 // Small counter to track the amount of memory currently used on the gpu
 size_t TextureCacheBase::texture_pool_memory_usage = 0;
 
@@ -62,6 +65,13 @@ void TextureCacheBase::CheckTempSize(size_t required_size)
 	temp = static_cast<u8*>(AllocateAlignedMemory(temp_size, 16));
 }
 
+static u64 GetTextureHash(const u8* src, u32 len, u32 samples)
+{
+	if (g_ActiveConfig.bFastTextureHash)
+		return GetXXH3Hash64(src, len, samples);
+	return GetHash64(src, len, samples);
+}
+
 TextureCacheBase::TextureCacheBase()
 {
 	temp_size = 2048 * 2048 * 4;
@@ -86,6 +96,7 @@ void TextureCacheBase::RequestInvalidateTextureCache()
 void TextureCacheBase::Invalidate()
 {
 	UnbindTextures();
+	InvalidateStageBindings();
 	TexCache::iterator iter = textures_by_address.begin();
 	TexCache::iterator end = textures_by_address.end();
 	while (iter != end)
@@ -127,10 +138,12 @@ TextureCacheBase::~TextureCacheBase()
 
 void TextureCacheBase::OnConfigChanged(VideoConfig& config)
 {
+	InvalidateStageBindings();
 	if (g_texture_cache)
 	{
 		// TODO: Invalidating texcache is really stupid in some of these cases
 		if (config.iSafeTextureCache_ColorSamples != backup_config.s_colorsamples ||
+			config.bFastTextureHash != backup_config.s_fast_texture_hash ||
 			config.bTexFmtOverlayEnable != backup_config.s_texfmt_overlay ||
 			config.bTexFmtOverlayCenter != backup_config.s_texfmt_overlay_center ||
 			config.bHiresTextures != backup_config.s_hires_textures ||
@@ -164,6 +177,7 @@ void TextureCacheBase::OnConfigChanged(VideoConfig& config)
 	}
 
 	backup_config.s_colorsamples = config.iSafeTextureCache_ColorSamples;
+	backup_config.s_fast_texture_hash = config.bFastTextureHash;
 	backup_config.s_texfmt_overlay = config.bTexFmtOverlayEnable;
 	backup_config.s_texfmt_overlay_center = config.bTexFmtOverlayCenter;
 	backup_config.s_hires_textures = config.bHiresTextures;
@@ -177,6 +191,8 @@ void TextureCacheBase::OnConfigChanged(VideoConfig& config)
 
 void TextureCacheBase::Cleanup(s32 _frameCount)
 {
+	// The CPU can modify textures at any time, make sure they are hashed at least once per frame
+	InvalidateStageBindings();
 	s32 texture_kill_threshold = TEXTURE_KILL_THRESHOLD;
 	if (texture_pool_memory_usage < (TEXTURE_POOL_MEMORY_LIMIT / 2))
 	{
@@ -466,6 +482,7 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::ReturnEntry(u32 stage, TCac
 {
 	entry->frameCount = FRAMECOUNT_INVALID;
 	bound_textures[stage] = entry;
+	s_stage_bindings[stage].entry = entry;
 	s_last_texture = std::max(s_last_texture, stage);
 	GFX_DEBUGGER_PAUSE_AT(NEXT_TEXTURE_CHANGE, true);
 	return entry;
@@ -498,6 +515,22 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 	u32 tex_levels = use_mipmaps ? ((tex.texMode1[id].max_lod + 0xf) / 0x10 + 1) : 1;
 	const bool from_tmem = tex.texImage1[id].image_type != 0;
 
+	// Nothing below can give a different result if neither the registers nor the memory changed
+	const u64 generation = s_texture_generation.load();
+	const u32 registers[7] = {
+		tex.texMode0[id].hex, tex.texMode1[id].hex,
+		tex.texImage0[id].hex, tex.texImage1[id].hex, tex.texImage2[id].hex, tex.texImage3[id].hex,
+		tex.texTlut[id].hex };
+	StageBinding& binding = s_stage_bindings[stage];
+	if (binding.entry && binding.generation == generation && !memcmp(binding.registers, registers, sizeof(registers)))
+	{
+		INCSTAT(stats.thisFrame.numTextureLoadsSkipped);
+		return ReturnEntry(stage, binding.entry);
+	}
+	memcpy(binding.registers, registers, sizeof(registers));
+	binding.generation = generation;
+	binding.entry = nullptr;
+
 	if (0 == address)
 		return nullptr;
 
@@ -564,13 +597,13 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 		FifoRecorder::GetInstance().UseMemory(address, texture_size + additional_mips_size, MemoryUpdate::TEXTURE_MAP);
 
 	// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)	
-	tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+	tex_hash = GetTextureHash(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
 	u32 palette_size = 0;
 	bool palette_upload_required = false;
 	if (isPaletteTexture)
 	{
 		palette_size = std::min(TexDecoder_GetPaletteSize(texformat), TMEM_SIZE - tlutaddr);
-		tlut_hash = GetHash64(&texMem[tlutaddr], palette_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+		tlut_hash = GetTextureHash(&texMem[tlutaddr], palette_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
 		palette_upload_required = s_prev_tlut_address != tlutaddr
 			|| s_prev_tlut_hash != tlut_hash
 			|| s_prev_tlut_size != palette_size;
@@ -908,6 +941,8 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32 dstStride, PEControl::PixelFormat srcFormat,
 	const EFBRectangle& srcRect, bool isIntensity, bool scaleByHalf)
 {
+	InvalidateStageBindings();
+
 	// Emulation methods:
 	// 
 	// - EFB to RAM:
@@ -1366,6 +1401,8 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::AllocateTexture(const TCach
 
 TextureCacheBase::TexCache::iterator TextureCacheBase::FreeTexture(TexCache::iterator iter)
 {
+	// A stage binding may still point to the entry
+	InvalidateStageBindings();
 	TCacheEntryBase* entry = iter->second;
 	entry->frameCount = FRAMECOUNT_INVALID;
 	if (entry->textures_by_hash_iter != textures_by_hash.end())
@@ -1423,7 +1460,12 @@ u64 TextureCacheBase::TCacheEntryBase::CalculateHash() const
 	u8* ptr = Memory::GetPointer(addr);
 	if (memory_stride == BytesPerRow())
 	{
-		return GetHash64(ptr, size_in_bytes, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+		return GetTextureHash(ptr, size_in_bytes, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+	}
+	else if (g_ActiveConfig.bFastTextureHash)
+	{
+		// Hashes all rows in one pass, spreading the samples over the whole copy
+		return GetXXH3Hash64Strided(ptr, BytesPerRow(), memory_stride, NumBlocksY(), g_ActiveConfig.iSafeTextureCache_ColorSamples);
 	}
 	else
 	{
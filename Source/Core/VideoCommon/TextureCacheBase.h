@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <atomic>
 #include <map>
 #include <unordered_map>
 #include <memory>
@@ -213,6 +214,10 @@ public:
 
 	static void RequestInvalidateTextureCache();
 
+	// Forces the next Load of every stage through the full lookup. Needed whenever texture
+	// memory or TMEM may have changed without any texture register changing.
+	static void InvalidateStageBindings() { s_texture_generation.fetch_add(1); }
+
 	virtual void LoadLut(u32 lutFmt, void* addr, u32 size) = 0;
 
 protected:
@@ -245,10 +250,21 @@ private:
 	static TCacheEntryBase* bound_textures[8];
 	static u32 s_last_texture;
 
+	// Texture registers of the last Load of each stage. Loads with the same registers and
+	// no texture memory changes in between return the same entry without hashing again.
+	static struct StageBinding
+	{
+		u32 registers[7];
+		u64 generation;
+		TCacheEntryBase* entry;
+	} s_stage_bindings[8];
+	static std::atomic<u64> s_texture_generation;
+
 	// Backup configuration values
 	static struct BackupConfig
 	{
 		s32 s_colorsamples;
+		bool s_fast_texture_hash;
 		bool s_texfmt_overlay;
 		bool s_texfmt_overlay_center;
 		bool s_hires_textures;
@@ -14,13 +14,16 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/LightingShaderGen.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/VideoConfig.h"
 
 static char text[VERTEXSHADERGEN_BUFFERSIZE];
 static const char *texOffsetMemberSelector[] = { "x", "y", "z", "w" };
 
-void GetVertexShaderUID(VertexShaderUid& out, u32 components, const XFMemory &xfr, const BPMemory &bpm)
+static ShaderUidCache<VertexShaderUid, 2> s_uid_cache(SHADER_UID_DIRTY_VERTEX);
+
+static void CalculateVertexShaderUID(VertexShaderUid& out, u32 components, const XFMemory &xfr, const BPMemory &bpm)
 {
 	out.ClearUID();
 	vertex_shader_uid_data& uid_data = out.GetUidData<vertex_shader_uid_data>();
@@ -84,6 +87,23 @@ void GetVertexShaderUID(VertexShaderUid& out, u32 components, const XFMemory &xf
 	out.CalculateUIDHash();
 }
 
+void GetVertexShaderUID(VertexShaderUid& out, u32 components, const XFMemory &xfr, const BPMemory &bpm)
+{
+	if (&bpm != &bpmem || &xfr != &xfmem)
+	{
+		CalculateVertexShaderUID(out, components, xfr, bpm);
+		return;
+	}
+	if (const VertexShaderUid* uid = s_uid_cache.Find(components))
+	{
+		out = *uid;
+		INCSTAT(stats.thisFrame.numShaderUidsReused);
+		return;
+	}
+	CalculateVertexShaderUID(out, components, xfr, bpm);
+	s_uid_cache.Insert(components, out);
+}
+
 template<API_TYPE api_type>
 inline void GenerateVertexShader(ShaderCode& out, const vertex_shader_uid_data& uid_data, bool use_integer_math)
 {
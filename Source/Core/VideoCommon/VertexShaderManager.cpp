@@ -198,6 +198,7 @@ void VertexShaderManager::Init()
 	Dirty();
 	m_buffer.Clear();
 	memset(&xfmem, 0, sizeof(xfmem));
+	SetShaderUidDirty(SHADER_UID_DIRTY_ALL);
 	ResetView();
 
 	// TODO: should these go inside ResetView()?
@@ -13,6 +13,7 @@
 #include "Core/Movie.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -24,6 +25,8 @@ void UpdateActiveConfig()
 	if (Movie::IsPlayingInput() && Movie::IsConfigSaved())
 		Movie::SetGraphicsConfig();
 	g_ActiveConfig = g_Config;
+	// Most UIDs carry backend and enhancement settings.
+	SetShaderUidDirty(SHADER_UID_DIRTY_ALL);
 }
 
 VideoConfig::VideoConfig()
@@ -72,6 +75,7 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("UseXFB", &bUseXFB, 0);
 	settings->Get("UseRealXFB", &bUseRealXFB, 0);
 	settings->Get("SafeTextureCacheColorSamples", &iSafeTextureCache_ColorSamples, 128);
+	settings->Get("FastTextureHash", &bFastTextureHash, true);
 	settings->Get("ShowFPS", &bShowFPS, false);
 	settings->Get("LogRenderTimeToFile", &bLogRenderTimeToFile, false);
 	settings->Get("ShowInputDisplay", &bShowInputDisplay, false);
@@ -87,6 +91,8 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("DumpEFBTarget", &bDumpEFBTarget, 0);
 	settings->Get("FreeLook", &bFreeLook, 0);
 	settings->Get("UseFFV1", &bUseFFV1, 0);
+	settings->Get("DumpFramesDropWhenBehind", &bDumpFramesDropWhenBehind, 0);
+	settings->Get("DumpEncoderThreads", &iDumpEncoderThreads, 0);
 	settings->Get("EnablePixelLighting", &bEnablePixelLighting, 0);
 	settings->Get("ForcePhongShading", &bForcePhongShading, 0);
 	settings->Get("RimPower", &iRimPower, 80);
@@ -209,6 +215,7 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Settings", "UseXFB", bUseXFB);
 	CHECK_SETTING("Video_Settings", "UseRealXFB", bUseRealXFB);
 	CHECK_SETTING("Video_Settings", "SafeTextureCacheColorSamples", iSafeTextureCache_ColorSamples);
+	CHECK_SETTING("Video_Settings", "FastTextureHash", bFastTextureHash);
 	CHECK_SETTING("Video_Settings", "HiresTextures", bHiresTextures);
 	CHECK_SETTING("Video_Settings", "HiresMaterialMaps", bHiresMaterialMaps);
 
@@ -386,6 +393,7 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("UseXFB", bUseXFB);
 	settings->Set("UseRealXFB", bUseRealXFB);
 	settings->Set("SafeTextureCacheColorSamples", iSafeTextureCache_ColorSamples);
+	settings->Set("FastTextureHash", bFastTextureHash);
 	settings->Set("ShowFPS", bShowFPS);
 	settings->Set("LogRenderTimeToFile", bLogRenderTimeToFile);
 	settings->Set("ShowInputDisplay", bShowInputDisplay);
@@ -402,6 +410,8 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("DumpEFBTarget", bDumpEFBTarget);
 	settings->Set("FreeLook", bFreeLook);
 	settings->Set("UseFFV1", bUseFFV1);
+	settings->Set("DumpFramesDropWhenBehind", bDumpFramesDropWhenBehind);
+	settings->Set("DumpEncoderThreads", iDumpEncoderThreads);
 	settings->Set("EnablePixelLighting", bEnablePixelLighting);
 	settings->Set("ForcePhongShading", bForcePhongShading);
 	settings->Set("RimPower", iRimPower);
@@ -145,6 +145,8 @@ struct VideoConfig final
 	bool bCacheHiresTexturesGPU;
 	bool bDumpEFBTarget;
 	bool bUseFFV1;
+	bool bDumpFramesDropWhenBehind;
+	int iDumpEncoderThreads;
 	bool bFreeLook;
 	bool bBorderlessFullscreen;
 
@@ -162,6 +164,7 @@ struct VideoConfig final
 	bool bSkipEFBCopyToRam;
 	bool bCopyEFBScaled;
 	int iSafeTextureCache_ColorSamples;
+	bool bFastTextureHash;
 	int iPhackvalue[4];
 	std::string sPhackvalue[2];
 	float fAspectRatioHackW, fAspectRatioHackH;
@@ -12,6 +12,7 @@
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/OpcodeDecoding.h"
 
 inline void XFMemWritten(u32 transferSize, u32 baseAddress)
@@ -53,7 +54,10 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 
 		case XFMEM_SETNUMCHAN:
 			if (xfmem.numChan.numColorChans != (newValue & 3))
+			{
 				VertexManagerBase::Flush();
+				SetShaderUidDirty(SHADER_UID_DIRTY_ALL);
+			}
 			break;
 
 		case XFMEM_SETCHAN0_AMBCOLOR: // Channel Ambient Color
@@ -87,12 +91,18 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETCHAN0_ALPHA: // Channel Alpha
 		case XFMEM_SETCHAN1_ALPHA:
 			if (((u32*)&xfmem)[address - 0x1000] != (newValue & 0x7fff))
+			{
 				VertexManagerBase::Flush();
+				SetShaderUidDirty(SHADER_UID_DIRTY_PIXEL | SHADER_UID_DIRTY_VERTEX | SHADER_UID_DIRTY_TESSELLATION);
+			}
 			break;
 
 		case XFMEM_DUALTEX:
 			if (xfmem.dualTexTrans.enabled != (newValue & 1))
+			{
 				VertexManagerBase::Flush();
+				SetShaderUidDirty(SHADER_UID_DIRTY_VERTEX);
+			}
 			break;
 
 
@@ -133,7 +143,10 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 
 		case XFMEM_SETNUMTEXGENS: // GXSetNumTexGens
 			if (xfmem.numTexGen.numTexGens != (newValue & 15))
+			{
 				VertexManagerBase::Flush();
+				SetShaderUidDirty(SHADER_UID_DIRTY_ALL);
+			}
 			break;
 
 		case XFMEM_SETTEXMTXINFO:
@@ -145,6 +158,7 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETTEXMTXINFO+6:
 		case XFMEM_SETTEXMTXINFO+7:
 			VertexManagerBase::Flush();
+			SetShaderUidDirty(SHADER_UID_DIRTY_PIXEL | SHADER_UID_DIRTY_VERTEX | SHADER_UID_DIRTY_TESSELLATION);
 
 			nextAddress = XFMEM_SETTEXMTXINFO + 8;
 			break;
@@ -158,6 +172,7 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETPOSMTXINFO+6:
 		case XFMEM_SETPOSMTXINFO+7:
 			VertexManagerBase::Flush();
+			SetShaderUidDirty(SHADER_UID_DIRTY_VERTEX);
 
 			nextAddress = XFMEM_SETPOSMTXINFO + 8;
 			break;
@@ -4,6 +4,7 @@
 
 #include <cmath>
 
+#include "Common/Assert.h"
 #include "Common/Common.h"
 //#include "VideoCommon/VideoCommon.h" // to get debug logs
 
@@ -614,10 +615,10 @@ inline u32 makeRGBA(u32 r, u32 g, u32 b, u32 a)
 	return (a<<24)|(b<<16)|(g<<8)|r;
 }
 
-inline void decodeDXTBlock(u32 *dst, const DXT1Block *src, u32 pitch)
+inline void decodeDXTPalette(u32 *colors, const DXT1Block *src, bool rgba)
 {
 	// S3TC Decoder (Note: GCN decodes differently from PC so we can't use native support)
-	// Needs more speed.
+	u32 (*make)(u32, u32, u32, u32) = rgba ? makeRGBA : makecol;
 	u16 c1 = Common::swap16(src->color1);
 	u16 c2 = Common::swap16(src->color2);
 	u32 blue1 = Convert5To8(c1 & 0x1F);
@@ -626,24 +627,30 @@ inline void decodeDXTBlock(u32 *dst, const DXT1Block *src, u32 pitch)
 	u32 green2 = Convert6To8((c2 >> 5) & 0x3F);
 	u32 red1 = Convert5To8((c1 >> 11) & 0x1F);
 	u32 red2 = Convert5To8((c2 >> 11) & 0x1F);
-	u32 colors[4];
-	colors[0] = makecol(red1, green1, blue1, 255);
-	colors[1] = makecol(red2, green2, blue2, 255);
+	colors[0] = make(red1, green1, blue1, 255);
+	colors[1] = make(red2, green2, blue2, 255);
 	if (c1 > c2)
 	{
 		u32 blue3 = ((blue2 - blue1) >> 1) - ((blue2 - blue1) >> 3);
 		u32 green3 = ((green2 - green1) >> 1) - ((green2 - green1) >> 3);
 		u32 red3 = ((red2 - red1) >> 1) - ((red2 - red1) >> 3);
-		colors[2] = makecol(red1 + red3, green1 + green3, blue1 + blue3, 255);
-		colors[3] = makecol(red2 - red3, green2 - green3, blue2 - blue3, 255); 
+		colors[2] = make(red1 + red3, green1 + green3, blue1 + blue3, 255);
+		colors[3] = make(red2 - red3, green2 - green3, blue2 - blue3, 255);
 	}
 	else
 	{
-		colors[2] = makecol((red1 + red2 + 1) / 2, // Average
+		colors[2] = make((red1 + red2 + 1) / 2, // Average
 							(green1 + green2 + 1) / 2,
 							(blue1 + blue2 + 1) / 2, 255);
-		colors[3] = makecol(red2, green2, blue2, 0);  // Color2 but transparent
+		colors[3] = make(red2, green2, blue2, 0);  // Color2 but transparent
 	}
+}
+
+inline void decodeDXTBlock(u32 *dst, const DXT1Block *src, u32 pitch)
+{
+	// Needs more speed.
+	u32 colors[4];
+	decodeDXTPalette(colors, src, false);
 
 	for (u32 y = 0; y < 4; y++)
 	{ 
@@ -659,34 +666,9 @@ inline void decodeDXTBlock(u32 *dst, const DXT1Block *src, u32 pitch)
 
 inline void decodeDXTBlockRGBA(u32 *dst, const DXT1Block *src, u32 pitch)
 {
-	// S3TC Decoder (Note: GCN decodes differently from PC so we can't use native support)
 	// Needs more speed.
-	u16 c1 = Common::swap16(src->color1);
-	u16 c2 = Common::swap16(src->color2);
-	u32 blue1 = Convert5To8(c1 & 0x1F);
-	u32 blue2 = Convert5To8(c2 & 0x1F);
-	u32 green1 = Convert6To8((c1 >> 5) & 0x3F);
-	u32 green2 = Convert6To8((c2 >> 5) & 0x3F);
-	u32 red1 = Convert5To8((c1 >> 11) & 0x1F);
-	u32 red2 = Convert5To8((c2 >> 11) & 0x1F);
 	u32 colors[4];
-	colors[0] = makeRGBA(red1, green1, blue1, 255);
-	colors[1] = makeRGBA(red2, green2, blue2, 255);
-	if (c1 > c2)
-	{
-		u32 blue3 = ((blue2 - blue1) >> 1) - ((blue2 - blue1) >> 3);
-		u32 green3 = ((green2 - green1) >> 1) - ((green2 - green1) >> 3);
-		u32 red3 = ((red2 - red1) >> 1) - ((red2 - red1) >> 3);        
-		colors[2] = makeRGBA(red1 + red3, green1 + green3, blue1 + blue3, 255);
-		colors[3] = makeRGBA(red2 - red3, green2 - green3, blue2 - blue3, 255); 
-	}
-	else
-	{
-		colors[2] = makeRGBA((red1 + red2 + 1) / 2, // Average
-							(green1 + green2 + 1) / 2,
-							(blue1 + blue2 + 1) / 2, 255);
-		colors[3] = makeRGBA(red2, green2, blue2, 0);  // Color2 but transparent
-	}
+	decodeDXTPalette(colors, src, true);
 
 	for (u32 y = 0; y < 4; y++)
 	{ 
@@ -745,6 +727,248 @@ inline void DXT1ToDXT3Block(DXT3Block* dst, const DXT1Block* src)
 	*dst = result;
 }
 
+// AVX2 decoders. These are built for AVX2 independently of the compiler flags
+// and must only be used when cpu_info.bAVX2 is set. Each one produces output
+// identical to the scalar decoder of the same format, it just handles several
+// blocks per iteration.
+
+FUNCTION_TARGET_AVX2
+static inline __m256i LoadHalves_AVX2(const u8* lo, const u8* hi)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)lo)),
+	                               _mm_loadu_si128((const __m128i*)hi), 1);
+}
+
+// Blocks made of four 8-byte rows (I8, IA4, IA8, RGB565): transposes four
+// horizontally adjacent blocks into four 32-byte texture rows.
+FUNCTION_TARGET_AVX2
+static inline void TransposeBlocks8x4_AVX2(const u8* src, __m256i rows[4])
+{
+	const __m256i b0 = _mm256_loadu_si256((const __m256i*)src);
+	const __m256i b1 = _mm256_loadu_si256((const __m256i*)src + 1);
+	const __m256i b2 = _mm256_loadu_si256((const __m256i*)src + 2);
+	const __m256i b3 = _mm256_loadu_si256((const __m256i*)src + 3);
+	// Rows 0 and 2 of each block, then rows 1 and 3.
+	const __m256i even01 = _mm256_unpacklo_epi64(b0, b1);
+	const __m256i even23 = _mm256_unpacklo_epi64(b2, b3);
+	const __m256i odd01 = _mm256_unpackhi_epi64(b0, b1);
+	const __m256i odd23 = _mm256_unpackhi_epi64(b2, b3);
+	rows[0] = _mm256_permute2x128_si256(even01, even23, 0x20);
+	rows[1] = _mm256_permute2x128_si256(odd01, odd23, 0x20);
+	rows[2] = _mm256_permute2x128_si256(even01, even23, 0x31);
+	rows[3] = _mm256_permute2x128_si256(odd01, odd23, 0x31);
+}
+
+// I8, IA8 and RGB565 only need the blocks linearized (and byteswapped for the
+// 16-bit formats). Requires the row size to be a multiple of 32 bytes.
+FUNCTION_TARGET_AVX2
+static void DecodeLinear8x4Blocks_AVX2(u8* dst, const u8* src, u32 row_bytes, u32 height, bool swap16)
+{
+	const __m256i kMaskSwap16 = _mm256_set_epi8(
+		14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+		14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+	for (u32 y = 0; y < height; y += 4)
+	{
+		u8* row = dst + y * row_bytes;
+		for (u32 x = 0; x < row_bytes; x += 32, src += 128)
+		{
+			__m256i rows[4];
+			TransposeBlocks8x4_AVX2(src, rows);
+			for (u32 iy = 0; iy < 4; iy++)
+			{
+				if (swap16)
+					rows[iy] = _mm256_shuffle_epi8(rows[iy], kMaskSwap16);
+				_mm256_storeu_si256((__m256i*)(row + iy * row_bytes + x), rows[iy]);
+			}
+		}
+	}
+}
+
+// Expands every nibble of src to 8 bits, (n << 4) | n, high nibble first.
+FUNCTION_TARGET_AVX2
+static inline void ExpandNibbles_AVX2(__m256i src, __m256i* hi, __m256i* lo)
+{
+	const __m256i kMask_x0f = _mm256_set1_epi8(0x0f);
+	const __m256i h = _mm256_and_si256(_mm256_srli_epi16(src, 4), kMask_x0f);
+	const __m256i l = _mm256_and_si256(src, kMask_x0f);
+	*hi = _mm256_or_si256(h, _mm256_slli_epi16(h, 4));
+	*lo = _mm256_or_si256(l, _mm256_slli_epi16(l, 4));
+}
+
+// One 8x8 block per iteration; every 4-byte source row becomes 8 I8 texels.
+// Requires width to be a multiple of 8.
+FUNCTION_TARGET_AVX2
+static void DecodeI4_AVX2(u8* dst, const u8* src, u32 width, u32 height)
+{
+	_dbg_assert_msg_(VIDEO, width % 8 == 0, "I4 width %u is not a multiple of 8", width);
+	for (u32 y = 0; y < height; y += 8)
+	{
+		for (u32 x = 0; x < width; x += 8, src += 32)
+		{
+			__m256i hi, lo;
+			ExpandNibbles_AVX2(_mm256_loadu_si256((const __m256i*)src), &hi, &lo);
+			// Rows 0,1 | 4,5 and rows 2,3 | 6,7.
+			const __m256i r0145 = _mm256_unpacklo_epi8(hi, lo);
+			const __m256i r2367 = _mm256_unpackhi_epi8(hi, lo);
+			const __m128i r01 = _mm256_castsi256_si128(r0145);
+			const __m128i r23 = _mm256_castsi256_si128(r2367);
+			const __m128i r45 = _mm256_extracti128_si256(r0145, 1);
+			const __m128i r67 = _mm256_extracti128_si256(r2367, 1);
+			u8* out = dst + y * width + x;
+			_mm_storel_epi64((__m128i*)(out + 0 * width), r01);
+			_mm_storel_epi64((__m128i*)(out + 1 * width), _mm_srli_si128(r01, 8));
+			_mm_storel_epi64((__m128i*)(out + 2 * width), r23);
+			_mm_storel_epi64((__m128i*)(out + 3 * width), _mm_srli_si128(r23, 8));
+			_mm_storel_epi64((__m128i*)(out + 4 * width), r45);
+			_mm_storel_epi64((__m128i*)(out + 5 * width), _mm_srli_si128(r45, 8));
+			_mm_storel_epi64((__m128i*)(out + 6 * width), r67);
+			_mm_storel_epi64((__m128i*)(out + 7 * width), _mm_srli_si128(r67, 8));
+		}
+	}
+}
+
+// Four 8x4 blocks per iteration. Requires width to be a multiple of 32.
+FUNCTION_TARGET_AVX2
+static void DecodeIA4_AVX2(u16* dst, const u8* src, u32 width, u32 height)
+{
+	for (u32 y = 0; y < height; y += 4)
+	{
+		for (u32 x = 0; x < width; x += 32, src += 128)
+		{
+			__m256i rows[4];
+			TransposeBlocks8x4_AVX2(src, rows);
+			for (u32 iy = 0; iy < 4; iy++)
+			{
+				__m256i a, l;
+				ExpandNibbles_AVX2(rows[iy], &a, &l);
+				// Texels 0-7 | 16-23 and 8-15 | 24-31.
+				const __m256i lo = _mm256_unpacklo_epi8(l, a);
+				const __m256i hi = _mm256_unpackhi_epi8(l, a);
+				__m256i* out = (__m256i*)(dst + (y + iy) * width + x);
+				_mm256_storeu_si256(out, _mm256_permute2x128_si256(lo, hi, 0x20));
+				_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+			}
+		}
+	}
+}
+
+// Two 4x4 blocks per iteration. Requires width to be a multiple of 8.
+FUNCTION_TARGET_AVX2
+static void DecodeRGB5A3_AVX2(u32* dst, const u8* src, u32 width, u32 height, bool rgba)
+{
+	const __m128i kMaskSwap16 = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+	const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+	const __m256i kMask_x0f = _mm256_set1_epi32(0x0f);
+	const __m256i kMask_x07 = _mm256_set1_epi32(0x07);
+	const __m256i kMask_x8000 = _mm256_set1_epi32(0x8000);
+	const __m256i kAlpha = _mm256_set1_epi32(0xff);
+	// Channel positions: BGRA is a << 24 | r << 16 | g << 8 | b, RGBA swaps r and b.
+	const int rshift = rgba ? 0 : 16;
+	const int bshift = rgba ? 16 : 0;
+	for (u32 y = 0; y < height; y += 4)
+	{
+		for (u32 x = 0; x < width; x += 8, src += 64)
+		{
+			for (u32 iy = 0; iy < 4; iy++)
+			{
+				const __m128i raw = _mm_unpacklo_epi64(
+					_mm_loadl_epi64((const __m128i*)(src + 8 * iy)),
+					_mm_loadl_epi64((const __m128i*)(src + 32 + 8 * iy)));
+				const __m256i val = _mm256_cvtepu16_epi32(_mm_shuffle_epi8(raw, kMaskSwap16));
+
+				// RGB555, alpha 0xFF
+				const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(val, 10), kMask_x1f);
+				const __m256i g5 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x1f);
+				const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+				const __m256i r5x = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+				const __m256i g5x = _mm256_or_si256(_mm256_slli_epi32(g5, 3), _mm256_srli_epi32(g5, 2));
+				const __m256i b5x = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+				const __m256i rgb555 = _mm256_or_si256(
+					_mm256_or_si256(_mm256_sll_epi32(r5x, _mm_cvtsi32_si128(rshift)), _mm256_slli_epi32(g5x, 8)),
+					_mm256_or_si256(_mm256_sll_epi32(b5x, _mm_cvtsi32_si128(bshift)), _mm256_slli_epi32(kAlpha, 24)));
+
+				// RGB4443
+				const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), kMask_x07);
+				const __m256i r4 = _mm256_and_si256(_mm256_srli_epi32(val, 8), kMask_x0f);
+				const __m256i g4 = _mm256_and_si256(_mm256_srli_epi32(val, 4), kMask_x0f);
+				const __m256i b4 = _mm256_and_si256(val, kMask_x0f);
+				const __m256i a3x = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(a3, 5), _mm256_slli_epi32(a3, 2)), _mm256_srli_epi32(a3, 1));
+				const __m256i r4x = _mm256_or_si256(_mm256_slli_epi32(r4, 4), r4);
+				const __m256i g4x = _mm256_or_si256(_mm256_slli_epi32(g4, 4), g4);
+				const __m256i b4x = _mm256_or_si256(_mm256_slli_epi32(b4, 4), b4);
+				const __m256i rgb4443 = _mm256_or_si256(
+					_mm256_or_si256(_mm256_sll_epi32(r4x, _mm_cvtsi32_si128(rshift)), _mm256_slli_epi32(g4x, 8)),
+					_mm256_or_si256(_mm256_sll_epi32(b4x, _mm_cvtsi32_si128(bshift)), _mm256_slli_epi32(a3x, 24)));
+
+				const __m256i opaque = _mm256_cmpeq_epi32(_mm256_and_si256(val, kMask_x8000), kMask_x8000);
+				_mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), _mm256_blendv_epi8(rgb4443, rgb555, opaque));
+			}
+		}
+	}
+}
+
+// Two 4x4 blocks per iteration. Requires width to be a multiple of 8.
+FUNCTION_TARGET_AVX2
+static void DecodeRGBA8_AVX2(u32* dst, const u8* src, u32 width, u32 height, bool rgba)
+{
+	// Interleaving the AR and GB halves of a block gives ARGB byte order.
+	const __m256i kMaskBGRA = _mm256_set_epi8(
+		12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+		12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	const __m256i kMaskRGBA = _mm256_set_epi8(
+		12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+		12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1);
+	const __m256i mask = rgba ? kMaskRGBA : kMaskBGRA;
+	for (u32 y = 0; y < height; y += 4)
+	{
+		for (u32 x = 0; x < width; x += 8, src += 128)
+		{
+			const __m256i ar01 = LoadHalves_AVX2(src, src + 64);
+			const __m256i ar23 = LoadHalves_AVX2(src + 16, src + 80);
+			const __m256i gb01 = LoadHalves_AVX2(src + 32, src + 96);
+			const __m256i gb23 = LoadHalves_AVX2(src + 48, src + 112);
+			u32* out = dst + y * width + x;
+			_mm256_storeu_si256((__m256i*)(out + 0 * width), _mm256_shuffle_epi8(_mm256_unpacklo_epi16(ar01, gb01), mask));
+			_mm256_storeu_si256((__m256i*)(out + 1 * width), _mm256_shuffle_epi8(_mm256_unpackhi_epi16(ar01, gb01), mask));
+			_mm256_storeu_si256((__m256i*)(out + 2 * width), _mm256_shuffle_epi8(_mm256_unpacklo_epi16(ar23, gb23), mask));
+			_mm256_storeu_si256((__m256i*)(out + 3 * width), _mm256_shuffle_epi8(_mm256_unpackhi_epi16(ar23, gb23), mask));
+		}
+	}
+}
+
+// Two horizontally adjacent DXT1 blocks share one 8-entry palette register, so
+// every output row is a single permute. Requires width to be a multiple of 8.
+FUNCTION_TARGET_AVX2
+static void DecodeCMPR_AVX2(u32* dst, const DXT1Block* src, u32 width, u32 height)
+{
+	const __m256i kShifts = _mm256_set_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+	const __m256i kPaletteBase = _mm256_set_epi32(4, 4, 4, 4, 0, 0, 0, 0);
+	const __m256i kMask_x03 = _mm256_set1_epi32(3);
+	for (u32 y = 0; y < height; y += 8)
+	{
+		for (u32 x = 0; x < width; x += 8)
+		{
+			for (u32 half = 0; half < 2; half++, src += 2)
+			{
+				alignas(32) u32 colors[8];
+				decodeDXTPalette(colors, src, false);
+				decodeDXTPalette(colors + 4, src + 1, false);
+				const __m256i palette = _mm256_load_si256((const __m256i*)colors);
+				u32* out = dst + (y + 4 * half) * width + x;
+				for (u32 iy = 0; iy < 4; iy++)
+				{
+					const __m256i lines = _mm256_set_epi32(
+						src[1].lines[iy], src[1].lines[iy], src[1].lines[iy], src[1].lines[iy],
+						src[0].lines[iy], src[0].lines[iy], src[0].lines[iy], src[0].lines[iy]);
+					const __m256i idx = _mm256_add_epi32(
+						_mm256_and_si256(_mm256_srlv_epi32(lines, kShifts), kMask_x03), kPaletteBase);
+					_mm256_storeu_si256((__m256i*)(out + iy * width), _mm256_permutevar8x32_epi32(palette, idx));
+				}
+			}
+		}
+	}
+}
+
 static PC_TexFormat GetPCFormatFromTLUTFormat(TlutFormat tlutfmt)
 {
 	switch (tlutfmt)
@@ -823,6 +1047,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 		return GetPCFormatFromTLUTFormat(tlutfmt);
 	case GX_TF_I4:
+		if (cpu_info.bAVX2 && width % 8 == 0)
+		{
+			DecodeI4_AVX2(dst, src, width, height);
+		}
+		else
 		{
 			for (u32 y = 0; y < height; y += 8)
 				for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
@@ -836,6 +1065,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 	   return PC_TEX_FMT_I4_AS_I8;
 	case GX_TF_I8:  // speed critical
+		if (cpu_info.bAVX2 && width % 32 == 0)
+		{
+			DecodeLinear8x4Blocks_AVX2(dst, src, width, height, false);
+		}
+		else
 		{
 			for (u32 y = 0; y < height; y += 4)
 				for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
@@ -875,6 +1109,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 		return GetPCFormatFromTLUTFormat(tlutfmt);
 	case GX_TF_IA4:
+		if (cpu_info.bAVX2 && width % 32 == 0)
+		{
+			DecodeIA4_AVX2((u16*)dst, src, width, height);
+		}
+		else
 		{
 			for (u32 y = 0; y < height; y += 4)
 				for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
@@ -883,6 +1122,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 		return PC_TEX_FMT_IA4_AS_IA8;
 	case GX_TF_IA8:
+		if (cpu_info.bAVX2 && width % 16 == 0)
+		{
+			DecodeLinear8x4Blocks_AVX2(dst, src, width * 2, height, true);
+		}
+		else
 		{
 			for (u32 y = 0; y < height; y += 4)
 				for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
@@ -914,6 +1158,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 		return GetPCFormatFromTLUTFormat(tlutfmt);
 	case GX_TF_RGB565:
+		if (cpu_info.bAVX2 && width % 16 == 0)
+		{
+			DecodeLinear8x4Blocks_AVX2(dst, src, width * 2, height, true);
+		}
+		else
 		{
 			for (u32 y = 0; y < height; y += 4)
 				for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
@@ -927,6 +1176,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 		return PC_TEX_FMT_RGB565;
 	case GX_TF_RGB5A3:
+		if (cpu_info.bAVX2 && width % 8 == 0)
+		{
+			DecodeRGB5A3_AVX2((u32*)dst, src, width, height, false);
+		}
+		else
 		{
 			for (u32 y = 0; y < height; y += 4)
 				for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
@@ -936,6 +1190,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 		}
 		return PC_TEX_FMT_BGRA32;
 	case GX_TF_RGBA8:  // speed critical
+		if (cpu_info.bAVX2 && width % 8 == 0)
+		{
+			DecodeRGBA8_AVX2((u32*)dst, src, width, height, false);
+		}
+		else
 		{
 
 #if _M_SSE >= 0x301
@@ -1019,6 +1278,11 @@ static PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, u32 width, u3
 				}
 				return PC_TEX_FMT_DXT3;
 			}
+			else if (cpu_info.bAVX2 && width % 8 == 0)
+			{
+				DecodeCMPR_AVX2((u32*)dst, (const DXT1Block*)src, width, height);
+				return PC_TEX_FMT_BGRA32;
+			}
 			else
 			{
 				for (u32 y = 0; y < height; y += 8)
@@ -1514,6 +1778,11 @@ static PC_TexFormat TexDecoder_Decode_RGBA(u32 * dst, const u8 * src, u32 width,
 		}
 		break;
 	case GX_TF_RGB5A3:
+		if (cpu_info.bAVX2 && width % 8 == 0)
+		{
+			DecodeRGB5A3_AVX2(dst, src, width, height, true);
+		}
+		else
 		{
 			const __m128i kMask_x1f = _mm_set1_epi32(0x0000001fL);
 			const __m128i kMask_x0f = _mm_set1_epi32(0x0000000fL);
@@ -1725,6 +1994,11 @@ static PC_TexFormat TexDecoder_Decode_RGBA(u32 * dst, const u8 * src, u32 width,
 		}
 		break;
 	case GX_TF_RGBA8:  // speed critical
+		if (cpu_info.bAVX2 && width % 8 == 0)
+		{
+			DecodeRGBA8_AVX2(dst, src, width, height, true);
+		}
+		else
 		{
 #if _M_SSE >= 0x301
 			// xsacha optimized with SSSE3 instrinsics
@@ -0,0 +1,67 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <string>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "VideoCommon/HiresTexturePack.h"
+#include "VideoCommon/HiresTextures.h"
+
+// Converts a directory of custom textures (Load/Textures/<GAMEID>) into a
+// <GAMEID>.dtp pack, which Dolphin picks up instead of the loose files.
+int main(int argc, const char* argv[])
+{
+	if (argc < 3)
+	{
+		printf("USAGE: TexturePackTool <GAMEID> <TEXTURE DIRECTORY> [OUTPUT FILE]\n");
+		printf("Decodes all custom textures in the directory into a single texture pack.\n");
+		printf("The pack is written next to the directory as <GAMEID>.dtp unless an output file is given.\n");
+		return 0;
+	}
+
+	const std::string game_id = argv[1];
+	std::string texture_directory = argv[2];
+	while (texture_directory.size() > 1 && (texture_directory.back() == '/' || texture_directory.back() == '\\'))
+		texture_directory.pop_back();
+
+	std::string pack_path;
+	if (argc > 3)
+	{
+		pack_path = argv[3];
+	}
+	else
+	{
+		std::string parent;
+		SplitPath(texture_directory, &parent, nullptr, nullptr);
+		pack_path = parent + game_id + ".dtp";
+	}
+
+	if (!File::IsDirectory(texture_directory))
+	{
+		printf("%s is not a directory\n", texture_directory.c_str());
+		return 1;
+	}
+
+	u32 start = Common::Timer::GetTimeMs();
+	if (!HiresTexture::BuildPack(game_id, texture_directory, pack_path))
+	{
+		printf("Failed to build %s\n", pack_path.c_str());
+		return 1;
+	}
+
+	HiresTexturePack pack;
+	if (!pack.Open(pack_path))
+	{
+		printf("Failed to verify %s\n", pack_path.c_str());
+		return 1;
+	}
+	printf("Wrote %u textures (%.1f MB) to %s in %.1f s\n", pack.GetEntryCount(),
+		File::GetSize(pack_path) / (1024.0 * 1024.0), pack_path.c_str(),
+		(Common::Timer::GetTimeMs() - start) / 1000.0);
+	return 0;
+}
@@ -0,0 +1,90 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/Hash.h"
+
+namespace
+{
+std::vector<u8> TestData(size_t size)
+{
+	std::vector<u8> data(size);
+	for (size_t i = 0; i < size; i++)
+		data[i] = static_cast<u8>(i * 7 + 1);
+	return data;
+}
+}
+
+TEST(Hash, XXH3MatchesReference)
+{
+	// Values produced by the reference xxHash 0.8 XXH3_64bits().
+	static const struct { u32 len; u64 hash; } vectors[] = {
+		{0, 0x2d06800538d394c2ULL},
+		{3, 0x5c83885a0fb5d516ULL},
+		{8, 0x96cc97a6768fd7a9ULL},
+		{16, 0x913bd4a8038027a7ULL},
+		{100, 0x985c0aa35f523fe6ULL},
+		{200, 0x70d27115faab301eULL},
+		{240, 0x3c0bb96864e543a1ULL},
+		{241, 0xbff7215089202d8fULL},
+		{1024, 0xac8e32e4ea3ba062ULL},
+		{4096, 0x99e3c931dab3e711ULL},
+		{65536, 0xcafa8d1474483c22ULL},
+	};
+
+	std::vector<u8> data = TestData(65536);
+	bool has_avx2 = cpu_info.bAVX2;
+	for (int avx2 = 0; avx2 <= has_avx2; avx2++)
+	{
+		cpu_info.bAVX2 = avx2 != 0;
+		for (const auto& v : vectors)
+			EXPECT_EQ(v.hash, GetXXH3Hash64(data.data(), v.len, 0)) << "len " << v.len << " avx2 " << avx2;
+	}
+	cpu_info.bAVX2 = has_avx2;
+}
+
+TEST(Hash, XXH3Sampled)
+{
+	std::vector<u8> data = TestData(65536);
+	u64 full = GetXXH3Hash64(data.data(), 65536, 0);
+
+	// Asking for at least as many samples as there are stripes hashes everything.
+	EXPECT_EQ(full, GetXXH3Hash64(data.data(), 65536, 1024));
+
+	// Sampled stripes must still affect the result, skipped ones must not.
+	u64 sampled = GetXXH3Hash64(data.data(), 65536, 16);
+	EXPECT_NE(full, sampled);
+	data[64] ^= 1;
+	EXPECT_EQ(sampled, GetXXH3Hash64(data.data(), 65536, 16));
+	data[0] ^= 1;
+	EXPECT_NE(sampled, GetXXH3Hash64(data.data(), 65536, 16));
+}
+
+TEST(Hash, XXH3Strided)
+{
+	const u32 row_len = 100, stride = 128, rows = 64;
+	std::vector<u8> source = TestData(row_len * rows);
+	std::vector<u8> strided(stride * rows, 0xCC);
+	for (u32 i = 0; i < rows; i++)
+		std::memcpy(&strided[i * stride], &source[i * row_len], row_len);
+
+	EXPECT_EQ(GetXXH3Hash64(source.data(), row_len * rows, 0),
+	          GetXXH3Hash64Strided(source.data(), row_len, row_len, rows, 0));
+
+	// Bytes between rows are not part of the texture.
+	u64 hash = GetXXH3Hash64Strided(strided.data(), row_len, stride, rows, 0);
+	strided[row_len] = 0;
+	EXPECT_EQ(hash, GetXXH3Hash64Strided(strided.data(), row_len, stride, rows, 0));
+	strided[stride * (rows - 1) + row_len - 1] ^= 1;
+	EXPECT_NE(hash, GetXXH3Hash64Strided(strided.data(), row_len, stride, rows, 0));
+
+	// Small copies are gathered and hashed contiguously.
+	EXPECT_EQ(GetXXH3Hash64(source.data(), row_len * 2, 0),
+	          GetXXH3Hash64Strided(strided.data(), row_len, stride, 2, 0));
+}
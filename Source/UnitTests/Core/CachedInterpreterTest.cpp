@@ -0,0 +1,291 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCTables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+namespace
+{
+const u32 CODE_ADDRESS = 0x00003000;
+const u32 DATA_ADDRESS = 0x00004000;
+const u32 DATA_SIZE = 0x100;
+
+// Just enough of an assembler for the instructions the cached interpreter fuses.
+u32 ADDI(u32 rd, u32 ra, s16 simm) { return (14 << 26) | (rd << 21) | (ra << 16) | (u16)simm; }
+u32 ADDIS(u32 rd, u32 ra, s16 simm) { return (15 << 26) | (rd << 21) | (ra << 16) | (u16)simm; }
+u32 LI(u32 rd, s16 simm) { return ADDI(rd, 0, simm); }
+u32 LIS(u32 rd, s16 simm) { return ADDIS(rd, 0, simm); }
+u32 ADD(u32 rd, u32 ra, u32 rb) { return (31 << 26) | (rd << 21) | (ra << 16) | (rb << 11) | (266 << 1); }
+u32 LWZ(u32 rd, s16 d, u32 ra) { return (32 << 26) | (rd << 21) | (ra << 16) | (u16)d; }
+u32 STW(u32 rs, s16 d, u32 ra) { return (36 << 26) | (rs << 21) | (ra << 16) | (u16)d; }
+u32 CMPWI(u32 crf, u32 ra, s16 simm) { return (11 << 26) | (crf << 23) | (ra << 16) | (u16)simm; }
+u32 CMPLWI(u32 crf, u32 ra, u16 uimm) { return (10 << 26) | (crf << 23) | (ra << 16) | uimm; }
+// bc with a byte offset from the branch itself
+u32 BC(u32 bo, u32 bi, s16 offset) { return (16 << 26) | (bo << 21) | (bi << 16) | ((u16)offset & 0xFFFC); }
+u32 BLT(u32 crf, s16 offset) { return BC(12, crf * 4 + 0, offset); }
+u32 BGT(u32 crf, s16 offset) { return BC(12, crf * 4 + 1, offset); }
+u32 BNE(u32 crf, s16 offset) { return BC(4, crf * 4 + 2, offset); }
+u32 BGE(u32 crf, s16 offset) { return BC(4, crf * 4 + 0, offset); }
+// b . where runs stop
+const u32 HALT = 18 << 26;
+
+struct CPUSnapshot
+{
+	u32 gpr[32];
+	u32 cr;
+	int downcount;
+	std::vector<u32> data;
+};
+
+enum class Backend
+{
+	Fused,
+	// Plain interpreter calls for every instruction, as with the JIT disabled in the debugger
+	Unfused,
+	Interpreter,
+	Jit64,
+};
+
+const char* BackendName(Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::Fused: return "fused";
+	case Backend::Unfused: return "unfused";
+	case Backend::Interpreter: return "interpreter";
+	case Backend::Jit64: return "Jit64";
+	}
+	return "";
+}
+}
+
+// Runs the same program with the fused handlers, with plain interpreter calls, with the
+// interpreter and with Jit64, and compares the results.
+class CachedInterpreterTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		// Nothing installs the fault handler fastmem needs
+		SConfig::GetInstance().bFastmem = false;
+		Memory::Init();
+		PPCTables::InitTables(PowerPC::CORE_JIT64);
+#if _M_X86_64
+		m_jit64 = JitInterface::InitJitCore(PowerPC::CORE_JIT64);
+#endif
+		jit = &m_cpu;
+		m_cpu.Init();
+	}
+
+	void TearDown() override
+	{
+		m_cpu.Shutdown();
+		jit = nullptr;
+#if _M_X86_64
+		jit = static_cast<JitBase*>(m_jit64);
+		JitInterface::Shutdown();
+#endif
+		Memory::Shutdown();
+		SConfig::Shutdown();
+	}
+
+	void Assemble(const std::vector<u32>& program)
+	{
+		m_end = CODE_ADDRESS;
+		for (u32 inst : program)
+		{
+			Memory::Write_U32(inst, m_end);
+			m_end += 4;
+		}
+		Memory::Write_U32(HALT, m_end);
+	}
+
+	CPUSnapshot Run(Backend backend)
+	{
+		SConfig::GetInstance().bJITOff = backend == Backend::Unfused;
+
+		for (u32 i = 0; i < DATA_SIZE / 4; i++)
+			Memory::Write_U32(i * 0x01010101 - 3, DATA_ADDRESS + i * 4);
+		for (u32& gpr : rGPR)
+			gpr = 0;
+		SetCR(0);
+		PowerPC::ppcState.msr = 0;
+		PowerPC::ppcState.Exceptions = 0;
+		PowerPC::ppcState.downcount = 1 << 30;
+		PC = CODE_ADDRESS;
+
+		// Each step runs one block (or one instruction for the interpreter), or compiles the
+		// block the first time it is reached. Jit64 runs until the end of a timing slice.
+		CPUCoreBase* core = backend == Backend::Interpreter ? Interpreter::getInstance() :
+		                    backend == Backend::Jit64 ? m_jit64 : &m_cpu;
+		jit = backend == Backend::Jit64 ? static_cast<JitBase*>(m_jit64) : &m_cpu;
+		core->ClearCache();
+		for (int steps = 0; PC != m_end && steps < 1000000; steps++)
+		{
+			if (backend == Backend::Jit64)
+				core->Run();
+			else
+				core->SingleStep();
+		}
+		EXPECT_EQ(m_end, PC) << BackendName(backend);
+
+		CPUSnapshot snapshot;
+		for (int i = 0; i < 32; i++)
+			snapshot.gpr[i] = rGPR[i];
+		snapshot.cr = GetCR();
+		snapshot.downcount = PowerPC::ppcState.downcount;
+		for (u32 i = 0; i < DATA_SIZE / 4; i++)
+			snapshot.data.push_back(Memory::Read_U32(DATA_ADDRESS + i * 4));
+		jit = &m_cpu;
+		return snapshot;
+	}
+
+	void ExpectSameResults()
+	{
+		std::vector<Backend> others = {Backend::Unfused, Backend::Interpreter};
+#if _M_X86_64
+		others.push_back(Backend::Jit64);
+#endif
+		for (Backend backend : others)
+		{
+			CPUSnapshot expected = Run(backend);
+			CPUSnapshot fused = Run(Backend::Fused);
+			const char* name = BackendName(backend);
+			for (int i = 0; i < 32; i++)
+				EXPECT_EQ(expected.gpr[i], fused.gpr[i]) << name << " r" << i;
+			// Jit64 doesn't emulate SO for cmp, a negative difference can leave it set
+			u32 cr_mask = backend == Backend::Jit64 ? 0xEEEEEEEE : 0xFFFFFFFF;
+			EXPECT_EQ(expected.cr & cr_mask, fused.cr & cr_mask) << name;
+			EXPECT_TRUE(expected.data == fused.data) << name;
+			// The other backends count cycles differently
+			if (backend == Backend::Unfused)
+			{
+				EXPECT_EQ(expected.downcount, fused.downcount);
+			}
+		}
+	}
+
+	CachedInterpreter m_cpu;
+	CPUCoreBase* m_jit64 = nullptr;
+	u32 m_end;
+};
+
+TEST_F(CachedInterpreterTest, AddImmediateChains)
+{
+	Assemble({
+		LIS(3, 0x1234), ADDI(3, 3, 0x5678),
+		LIS(4, -1), ADDI(4, 4, -0x8000), ADDIS(4, 4, 2), ADDI(4, 4, 1),
+		LI(5, -5), ADDI(5, 5, 0x7FFF),
+		// Not a chain: different destination, rA == 0, and a different source register
+		ADDI(6, 3, 1), ADDI(7, 0, 2), ADDI(7, 6, 3),
+	});
+	ExpectSameResults();
+	EXPECT_EQ(0x12345678u, rGPR[3]);
+	EXPECT_EQ(0x8001u, rGPR[4]);
+	EXPECT_EQ(0x7FFAu, rGPR[5]);
+}
+
+TEST_F(CachedInterpreterTest, LoadAndStoreWords)
+{
+	Assemble({
+		LI(4, DATA_ADDRESS + 0x80),
+		LWZ(5, 0, 4), LWZ(6, -4, 4), LWZ(7, 0x7C, 4),
+		ADD(8, 5, 6),
+		STW(8, 4, 4), STW(7, -0x80, 4),
+		LWZ(4, 8, 4), // overwrites the base register
+		LWZ(9, DATA_ADDRESS + 0x10, 0),
+		STW(9, DATA_ADDRESS + 0x14, 0),
+	});
+	ExpectSameResults();
+}
+
+TEST_F(CachedInterpreterTest, LoadAndCompare)
+{
+	Assemble({
+		LI(4, DATA_ADDRESS),
+		LWZ(5, 0, 4), CMPWI(0, 5, -3),
+		LWZ(6, 4, 4), CMPLWI(1, 6, 0x1000),
+		LWZ(7, 8, 4), CMPWI(7, 7, 0x7FFF),
+		// The compare is of a different register, so it isn't fused
+		LWZ(8, 12, 4), CMPWI(2, 5, 0),
+	});
+	ExpectSameResults();
+}
+
+TEST_F(CachedInterpreterTest, CompareAndBranch)
+{
+	Assemble({
+		LI(3, 0), LI(4, 100), LI(5, 0),
+		// loop: count r3 up to 10 and r4 down, branching on cr0 and cr1
+		ADDI(3, 3, 1),
+		ADDI(4, 4, -7),
+		CMPWI(1, 4, 50), BGT(1, 8),
+		ADDI(5, 5, 1),
+		CMPLWI(0, 3, 10), BLT(0, -24),
+		CMPWI(2, 5, 3), BNE(2, 8),
+		LI(6, 1),
+		CMPLWI(3, 4, 0xFFFF), BGE(3, 8),
+		LI(7, 1),
+	});
+	ExpectSameResults();
+	EXPECT_EQ(10u, rGPR[3]);
+}
+
+TEST_F(CachedInterpreterTest, SumLoop)
+{
+	Assemble({
+		LI(3, 0), LI(4, DATA_ADDRESS), LI(5, DATA_SIZE / 4),
+		// loop: r3 += *r4++, storing the running sum back
+		LWZ(6, 0, 4), CMPWI(0, 6, 0),
+		ADD(3, 3, 6),
+		STW(3, 0, 4),
+		ADDI(4, 4, 4),
+		ADDI(5, 5, -1),
+		CMPWI(0, 5, 0), BNE(0, -28),
+	});
+	ExpectSameResults();
+}
+
+// A benchmark rather than a test, run it with --gtest_also_run_disabled_tests. It reports
+// the time per guest instruction of a load/compare/store loop.
+TEST_F(CachedInterpreterTest, DISABLED_DispatchCost)
+{
+	const u16 ITERATIONS = 50000;
+	const u32 LOOP_LENGTH = 7;
+	Assemble({
+		LI(3, 0), LI(4, DATA_ADDRESS),
+		LWZ(6, 0, 4), CMPWI(1, 6, 0),
+		ADDI(6, 6, 1),
+		STW(6, 0, 4),
+		ADDI(3, 3, 1),
+		CMPLWI(0, 3, ITERATIONS), BLT(0, -20),
+	});
+
+	auto ns_per_instruction = [&](Backend backend) {
+		auto start = std::chrono::steady_clock::now();
+		Run(backend);
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(end - start).count() /
+		       (ITERATIONS * LOOP_LENGTH);
+	};
+	// Warm up, then measure
+	ns_per_instruction(Backend::Fused);
+	for (Backend backend : {Backend::Fused, Backend::Unfused, Backend::Interpreter})
+		printf("%s: %.2f ns per instruction\n", BackendName(backend), ns_per_instruction(backend));
+}
@@ -0,0 +1,211 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_FPUtils.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCTables.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+static u64 Bits(double value)
+{
+	u64 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+// (1 + 2^-30)^2 - (1 + 2^-29) is exactly 2^-60, but rounding the product first gives 0.
+static const double s_a = 1.0 + std::ldexp(1.0, -30);
+static const double s_c = 1.0 + std::ldexp(1.0, -30);
+static const double s_b = 1.0 + std::ldexp(1.0, -29);
+
+TEST(FusedMultiplyAdd, InterpreterDoesNotRoundProduct)
+{
+	EXPECT_EQ(std::ldexp(1.0, -60), NI_madd(s_a, s_c, -s_b));
+	EXPECT_EQ(std::ldexp(1.0, -60), NI_msub(s_a, s_c, s_b));
+}
+
+// Without NaNs involved, both must give the single rounding of std::fma bit for bit.
+TEST(FusedMultiplyAdd, InterpreterMatchesStdFma)
+{
+	auto check = [](double a, double c, double b)
+	{
+		EXPECT_EQ(Bits(std::fma(a, c, b)), Bits(NI_madd(a, c, b))) << a << " * " << c << " + " << b;
+		EXPECT_EQ(Bits(std::fma(a, c, -b)), Bits(NI_msub(a, c, b))) << a << " * " << c << " - " << b;
+	};
+
+	check(s_a, s_c, s_b);
+	check(s_a, s_c, -s_b);
+	// Exact cancellation, signed zeros, overflow and denormal results
+	check(1.0, 1.0, 1.0);
+	check(-1.0, 1.0, -1.0);
+	check(0.0, -1.0, 0.0);
+	check(-0.0, 1.0, -0.0);
+	check(1e300, 1e300, -1e300);
+	check(std::ldexp(1.0, -1000), std::ldexp(1.0, -60), std::ldexp(1.0, -1070));
+	check(HUGE_VAL, 2.0, 1.0);
+
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+	std::uniform_int_distribution<int> exponent(-60, 60);
+	for (int i = 0; i < 100000; i++)
+	{
+		double a = std::ldexp(dist(rng), exponent(rng));
+		double c = std::ldexp(dist(rng), exponent(rng));
+		check(a, c, a * c * (dist(rng) / 1000.0));
+		check(a, c, std::ldexp(dist(rng), exponent(rng)));
+	}
+}
+
+#if _M_X86_64
+// Runs the multiply-add instructions through Jit64 and the interpreter with the same inputs,
+// and compares the results bit for bit.
+class Jit64FusedMultiplyAddTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		// Nothing here touches guest memory through the JIT, so no fault handler is needed
+		SConfig::GetInstance().bFastmem = false;
+		// Without FMA3 Jit64 only promises the interpreter's results in deterministic mode
+		m_saved_determinism = Core::g_want_determinism;
+		if (!cpu_info.bFMA)
+			Core::g_want_determinism = true;
+		Memory::Init();
+		PPCTables::InitTables(PowerPC::CORE_JIT64);
+		JitInterface::InitJitCore(PowerPC::CORE_JIT64);
+	}
+
+	void TearDown() override
+	{
+		JitInterface::Shutdown();
+		Memory::Shutdown();
+		Core::g_want_determinism = m_saved_determinism;
+		SConfig::Shutdown();
+	}
+
+	struct Inputs
+	{
+		double a[2], b[2], c[2];
+	};
+
+	void SetInputs(const Inputs& in)
+	{
+		PowerPC::ppcState.msr = 0x2000;  // MSR.FP
+		PowerPC::ppcState.fpscr = 0;
+		for (int i = 0; i < 2; i++)
+		{
+			PowerPC::ppcState.ps[FD][i] = 0;
+			std::memcpy(&PowerPC::ppcState.ps[FA][i], &in.a[i], sizeof(double));
+			std::memcpy(&PowerPC::ppcState.ps[FB][i], &in.b[i], sizeof(double));
+			std::memcpy(&PowerPC::ppcState.ps[FC][i], &in.c[i], sizeof(double));
+		}
+	}
+
+	// The instruction, followed by a branch to itself that runs until the slice is over
+	void RunJit(const Inputs& in)
+	{
+		SetInputs(in);
+		PC = CODE_ADDRESS;
+		jit->Run();
+	}
+
+	void RunInterpreter(u32 inst, const Inputs& in)
+	{
+		SetInputs(in);
+		Interpreter::m_opTable[inst >> 26](inst);
+	}
+
+	void Check(u32 inst, const char* name)
+	{
+		Memory::Write_U32(inst, CODE_ADDRESS);
+		Memory::Write_U32(18 << 26, CODE_ADDRESS + 4);
+		jit->ClearCache();
+
+		auto check = [&](const Inputs& in)
+		{
+			RunJit(in);
+			u64 jit_result[2] = {PowerPC::ppcState.ps[FD][0], PowerPC::ppcState.ps[FD][1]};
+			RunInterpreter(inst, in);
+			for (int i = 0; i < 2; i++)
+			{
+				ASSERT_EQ(PowerPC::ppcState.ps[FD][i], jit_result[i])
+					<< name << " ps" << i << ": " << in.a[i] << " * " << in.c[i] << " +- " << in.b[i];
+			}
+		};
+
+		check({{s_a, s_a}, {s_b, -s_b}, {s_c, s_c}});
+		check({{1.0, -1.0}, {1.0, -1.0}, {1.0, 1.0}});
+		check({{0.0, -0.0}, {0.0, -0.0}, {-1.0, 1.0}});
+		check({{1e300, 1e30}, {-1e300, 1e38}, {1e300, 1e10}});
+		check({{std::ldexp(1.0, -1000), 1.0}, {std::ldexp(1.0, -1070), std::ldexp(1.0, -149)},
+		       {std::ldexp(1.0, -60), std::ldexp(1.0, -140)}});
+
+		std::mt19937 rng(0);
+		std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+		std::uniform_int_distribution<int> exponent(-60, 60);
+		auto random = [&] { return std::ldexp(dist(rng), exponent(rng)); };
+		for (int i = 0; i < 2000; i++)
+		{
+			Inputs in;
+			for (int j = 0; j < 2; j++)
+			{
+				in.a[j] = random();
+				in.c[j] = random();
+				// Half of the time close to cancelling the product
+				in.b[j] = (i & 1) ? random() : -in.a[j] * in.c[j] * (1.0 + dist(rng) / 1e9);
+			}
+			check(in);
+		}
+	}
+
+	static u32 AForm(u32 opcd, u32 xo)
+	{
+		return (opcd << 26) | (FD << 21) | (FA << 16) | (FB << 11) | (FC << 6) | (xo << 1);
+	}
+
+	static const u32 CODE_ADDRESS = 0x00003000;
+	static const u32 FD = 1, FA = 2, FB = 3, FC = 4;
+	bool m_saved_determinism;
+};
+
+TEST_F(Jit64FusedMultiplyAddTest, Double)
+{
+	Check(AForm(63, 29), "fmadd");
+	Check(AForm(63, 28), "fmsub");
+	Check(AForm(63, 31), "fnmadd");
+	Check(AForm(63, 30), "fnmsub");
+}
+
+TEST_F(Jit64FusedMultiplyAddTest, Single)
+{
+	Check(AForm(59, 29), "fmadds");
+	Check(AForm(59, 28), "fmsubs");
+	Check(AForm(59, 31), "fnmadds");
+	Check(AForm(59, 30), "fnmsubs");
+}
+
+TEST_F(Jit64FusedMultiplyAddTest, Paired)
+{
+	Check(AForm(4, 29), "ps_madd");
+	Check(AForm(4, 28), "ps_msub");
+	Check(AForm(4, 31), "ps_nmadd");
+	Check(AForm(4, 30), "ps_nmsub");
+	Check(AForm(4, 14), "ps_madds0");
+	Check(AForm(4, 15), "ps_madds1");
+}
+#endif
@@ -0,0 +1,90 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/PowerPC/CachedInterpreter.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+// Uses the cached interpreter's block cache, which doesn't emit any code to patch.
+class JitCacheTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		jit = &m_cpu;
+		m_cpu.Init();
+		m_cache = m_cpu.GetBlockCache();
+	}
+
+	void TearDown() override
+	{
+		m_cpu.Shutdown();
+		jit = nullptr;
+		SConfig::Shutdown();
+	}
+
+	int AddBlock(u32 address, u32 size, const std::vector<std::pair<u32, u32>>& ranges = {})
+	{
+		int block_num = m_cache->AllocateBlock(address);
+		JitBlock* b = m_cache->GetBlock(block_num);
+		b->originalSize = size;
+		b->codeRanges = ranges;
+		m_cache->FinalizeBlock(block_num, false, nullptr);
+		return block_num;
+	}
+
+	bool IsValid(int block_num) { return !m_cache->GetBlock(block_num)->invalid; }
+
+	CachedInterpreter m_cpu;
+	JitBaseBlockCache* m_cache;
+};
+
+TEST_F(JitCacheTest, InvalidateBlock)
+{
+	int block = AddBlock(0x80000100, 0x40);
+	int other = AddBlock(0x80000200, 0x10);
+
+	m_cache->InvalidateICache(0x80000180, 0x20, true);
+	EXPECT_FALSE(IsValid(block));
+	EXPECT_TRUE(IsValid(other));
+}
+
+TEST_F(JitCacheTest, InvalidateBlockOverlappedByTrace)
+{
+	// A normal block 0x100..0x1FC, and a trace with a run 0x150..0x17C that ends at a
+	// followed branch in the middle of the block.
+	int block = AddBlock(0x80000100, 0x40);
+	int trace = AddBlock(0x80000300, 0x10, {{0x80000300, 0x4}, {0x80000150, 0xC}});
+
+	m_cache->InvalidateICache(0x80000100, 0x20, true);
+	EXPECT_FALSE(IsValid(block));
+	EXPECT_TRUE(IsValid(trace));
+
+	m_cache->InvalidateICache(0x80000160, 0x20, true);
+	EXPECT_FALSE(IsValid(trace));
+}
+
+TEST_F(JitCacheTest, InvalidateTraceThroughAnyRun)
+{
+	int trace = AddBlock(0x80000300, 0x10, {{0x80000300, 0x4}, {0x80000500, 0x8}});
+	int block = AddBlock(0x80000480, 0x40);
+
+	m_cache->InvalidateICache(0x80000510, 0x20, true);
+	EXPECT_FALSE(IsValid(trace));
+	EXPECT_FALSE(IsValid(block));
+
+	// Its other run still has an entry, for a block that is already gone
+	int again = AddBlock(0x80000300, 0x4);
+	m_cache->InvalidateICache(0x80000300, 0x20, true);
+	EXPECT_FALSE(IsValid(again));
+}
@@ -0,0 +1,102 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/HiresTexturePack.h"
+#include "VideoCommon/TextureDecoder.h"
+
+class HiresTexturePackTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		m_dir = File::CreateTempDir();
+		m_path = m_dir + DIR_SEP "test.dtp";
+	}
+
+	void TearDown() override
+	{
+		File::DeleteDirRecursively(m_dir);
+	}
+
+	bool WritePack(u32 count, PC_TexFormat format = PC_TEX_FMT_RGBA32)
+	{
+		HiresTexturePackWriter writer;
+		if (!writer.Open(m_path))
+			return false;
+		for (u32 i = 0; i < count; i++)
+		{
+			std::vector<u8> data(i * 4 + 4, static_cast<u8>(i));
+			HiresTexturePack::Entry entry = {};
+			entry.data_size = data.size();
+			entry.width = i + 1;
+			entry.height = 1;
+			entry.format = format;
+			entry.levels = 1;
+			if (!writer.Add("tex1_" + std::to_string(i), entry, data.data()))
+				return false;
+		}
+		return writer.Finish(HiresTexturePack::FLAG_NEW_NAMES);
+	}
+
+	std::string m_dir;
+	std::string m_path;
+};
+
+TEST_F(HiresTexturePackTest, RoundTrip)
+{
+	ASSERT_TRUE(WritePack(1000));
+
+	HiresTexturePack pack;
+	ASSERT_TRUE(pack.Open(m_path));
+	EXPECT_EQ(1000u, pack.GetEntryCount());
+	EXPECT_EQ(static_cast<u32>(HiresTexturePack::FLAG_NEW_NAMES), pack.GetFlags());
+
+	for (u32 i = 0; i < 1000; i++)
+	{
+		const HiresTexturePack::Entry* entry = pack.Find("tex1_" + std::to_string(i));
+		ASSERT_NE(nullptr, entry);
+		EXPECT_EQ(i + 1, entry->width);
+		ASSERT_EQ(i * 4 + 4, entry->data_size);
+		EXPECT_EQ(0u, entry->data_offset % 16);
+		const u8* data = pack.GetData(*entry);
+		EXPECT_EQ(static_cast<u8>(i), data[0]);
+		EXPECT_EQ(static_cast<u8>(i), data[entry->data_size - 1]);
+	}
+	EXPECT_EQ(nullptr, pack.Find("tex1_1000"));
+	EXPECT_EQ(nullptr, pack.Find(""));
+
+	// Index is sorted so that lookups can binary search
+	for (u32 i = 1; i < pack.GetEntryCount(); i++)
+		EXPECT_LE(pack.GetEntry(i - 1).name_hash, pack.GetEntry(i).name_hash);
+}
+
+TEST_F(HiresTexturePackTest, RejectsInvalidFiles)
+{
+	HiresTexturePack pack;
+	EXPECT_FALSE(pack.Open(m_path));
+
+	ASSERT_TRUE(File::WriteStringToFile("not a texture pack", m_path));
+	EXPECT_FALSE(pack.Open(m_path));
+	EXPECT_FALSE(pack.IsOpen());
+
+	// Truncating the index must be detected
+	ASSERT_TRUE(WritePack(10));
+	{
+		File::IOFile file(m_path, "r+b");
+		ASSERT_TRUE(file.Resize(file.GetSize() - sizeof(HiresTexturePack::Entry)));
+	}
+	EXPECT_FALSE(pack.Open(m_path));
+
+	// Only formats that can be uploaded as they are
+	ASSERT_TRUE(WritePack(10, PC_TEX_FMT_BGRA32));
+	EXPECT_FALSE(pack.Open(m_path));
+}
@@ -0,0 +1,113 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+const char* FormatName(u32 format)
+{
+	switch (format)
+	{
+	case GX_TF_I4: return "I4";
+	case GX_TF_I8: return "I8";
+	case GX_TF_IA4: return "IA4";
+	case GX_TF_IA8: return "IA8";
+	case GX_TF_RGB565: return "RGB565";
+	case GX_TF_RGB5A3: return "RGB5A3";
+	case GX_TF_RGBA8: return "RGBA8";
+	case GX_TF_CMPR: return "CMPR";
+	default: return "?";
+	}
+}
+
+// Restores the detected CPU features when a test toggles them.
+class ScopedAVX2
+{
+public:
+	explicit ScopedAVX2(bool enable) : m_saved(cpu_info.bAVX2) { cpu_info.bAVX2 = enable && m_saved; }
+	~ScopedAVX2() { cpu_info.bAVX2 = m_saved; }
+private:
+	bool m_saved;
+};
+}
+
+class TextureDecoderTest : public testing::TestWithParam<std::tuple<u32, u32, bool>>
+{
+protected:
+	void SetUp() override
+	{
+		std::tie(m_format, m_size, m_rgba) = GetParam();
+		m_src.resize(TexDecoder_GetTextureSizeInBytes(m_size, m_size, m_format));
+		srand(m_format * 1000 + m_size);
+		for (u8& b : m_src)
+			b = static_cast<u8>(rand());
+	}
+
+	std::vector<u8> Decode(bool avx2)
+	{
+		ScopedAVX2 scope(avx2);
+		std::vector<u8> dst(m_size * m_size * 4, 0xCD);
+		TexDecoder_Decode(dst.data(), m_src.data(), m_size, m_size, m_format, 0, GX_TL_IA8, m_rgba);
+		return dst;
+	}
+
+	u32 m_format;
+	u32 m_size;
+	bool m_rgba;
+	std::vector<u8> m_src;
+};
+
+extern int gtest_FormatsAndSizesTextureDecoderTest_dummy_;
+INSTANTIATE_TEST_CASE_P(
+	FormatsAndSizes, TextureDecoderTest,
+	::testing::Combine(
+		::testing::Values(GX_TF_I4, GX_TF_I8, GX_TF_IA4, GX_TF_IA8, GX_TF_RGB565,
+		                  GX_TF_RGB5A3, GX_TF_RGBA8, GX_TF_CMPR),
+		::testing::Values(8, 64, 256, 1024),
+		::testing::Bool() // rgba
+	)
+);
+
+TEST_P(TextureDecoderTest, VectorMatchesScalar)
+{
+	// This gtest has no GTEST_SKIP, so say why nothing was compared
+	if (!cpu_info.bAVX2)
+	{
+		printf("Skipped: the host has no AVX2, only the scalar decoders can run\n");
+		RecordProperty("skipped", "no AVX2");
+		return;
+	}
+	EXPECT_EQ(Decode(false), Decode(true));
+}
+
+// A benchmark rather than a test, run it with --gtest_also_run_disabled_tests.
+TEST_P(TextureDecoderTest, DISABLED_DecodeSpeed)
+{
+	for (bool avx2 : {false, true})
+	{
+		if (avx2 && !cpu_info.bAVX2)
+			break;
+		ScopedAVX2 scope(avx2);
+		std::vector<u8> dst(m_size * m_size * 4);
+		const int iterations = std::max(1u, (64u << 20) / static_cast<u32>(m_src.size()));
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+			TexDecoder_Decode(dst.data(), m_src.data(), m_size, m_size, m_format, 0, GX_TL_IA8, m_rgba);
+		std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+		printf("format: %s, size: %u, %s, %s: %.1f MB/s\n", FormatName(m_format), m_size,
+		       m_rgba ? "rgba" : "native", avx2 ? "avx2" : "default",
+		       iterations * m_src.size() / elapsed.count() / (1 << 20));
+	}
+}